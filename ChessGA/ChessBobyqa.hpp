@@ -0,0 +1,311 @@
+#pragma once
+//=================================================================================================
+//                    Copyright (C) 2017 Alain Lanthier - All Rights Reserved                      
+//=================================================================================================
+//
+//  ChessBobyqaOptimizer<...> : derivative free tuning of the player terminal node weights (dlib find_min_bobyqa)
+//
+//  Same parameters as ChessGeneticAlgorithm (all weight_sum weights of the terminal nodes, bounds +/-WEIGHT_BOUND)
+//  on a deterministic objective: a fixed set of openings is drawn once and each opening is paired with the
+//  game of the reference weights (the initial ones) against the same fixed opponent. The objective is the mean
+//  score difference, so it has no sampling noise and the opening difficulty cancels out.
+//  BOBYQA asks one point at a time: objective calls are sequential, the openings of a call are played concurrently
+//  on a GameBatch (the pool workers own clones of the players, a worker sets the point weights in its clone before a game).
+//
+#ifndef _AL_CHESS_CHESSGA_CHESSBOBYQA_HPP
+#define _AL_CHESS_CHESSGA_CHESSBOBYQA_HPP
+
+#include <ExternLib/dlib/optimization.h>
+
+namespace chess
+{
+    namespace ga
+    {
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        class ChessBobyqaOptimizer
+        {
+            using _Board = Board<PieceID, _BoardSize>;
+            using _ConditionValuationNode = ConditionValuationNode<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+            using _GameBatch = GameBatch<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+            using _DomainPlayer = DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+            typedef dlib::matrix<double, 0, 1> column_vector;
+
+        public:
+            ChessBobyqaOptimizer(   bool evolve_white, _DomainPlayer* player, _DomainPlayer* player_opposite, BaseGame_Config cfg,
+                                    size_t n_opening, size_t max_f_evals, char verbose = 0);
+            ~ChessBobyqaOptimizer() {}
+
+            // run() - tune the weights of the evolved player, returns the best score gain over the initial weights
+            double run();
+
+            size_t  num_f_evals()   const { return _n_eval; }
+            double  best_gain()     const { return _best; }         // mean score gain of the tuned weights over the initial ones
+            double  best_score()    const { return _best_score; }   // mean score of the tuned weights on the openings
+            size_t  num_params()    const { return _lower.size(); }
+
+            // set_task_pool() - games played by the pool workers, nullptr: own workers
+            void    set_task_pool(TaskPool* pool) { _pool = pool; }
+
+            static void set_rho_begin(double v)     { _rho_begin = v; }
+            static void set_rho_end(double v)       { _rho_end = v; }
+            static void set_ply_shaping(double v)   { _ply_shaping = v; }
+
+        protected:
+            void    setup_params();
+            void    set_params(const std::vector<TYPE_PARAM>& param);
+            void    set_node_params(const std::vector<_ConditionValuationNode*>& nodes, const std::vector<TYPE_PARAM>& param) const;
+            void    play_openings(std::vector<double>& ret_scores);
+            double  objective(const column_vector& x);
+            double  game_score(ExactScore sc, size_t ply) const;
+
+            static double   _rho_begin;     // initial trust region radius, fraction of WEIGHT_BOUND
+            static double   _rho_end;       // final trust region radius, fraction of WEIGHT_BOUND
+            static double   _ply_shaping;   // faster win/slower loss bonus, breaks the ties of equal game results
+
+        private:
+            bool                                    _evolve_white;
+            _DomainPlayer*                          _player;            // evolved
+            _DomainPlayer*                          _player_opposite;   // fixed opponent
+            std::vector<_ConditionValuationNode*>   _player_terminal_nodes;
+            BaseGame_Config                         _cfg;
+            TaskPool*                               _pool = nullptr;
+            std::unique_ptr<_GameBatch>             _batch;             // one game per opening, made by run()
+            size_t                                  _n_opening;
+            size_t                                  _max_f_evals;
+            char                                    _verbose;
+
+            std::vector<TYPE_PARAM>                 _lower;
+            std::vector<TYPE_PARAM>                 _upper;
+            std::vector<TYPE_PARAM>                 _initial;
+            std::vector<TYPE_PARAM>                 _param;             // point of the current objective call
+            std::vector<_Board>                     _openings;
+            std::vector<double>                     _ref_scores;        // scores of the initial weights per opening
+            size_t                                  _n_eval = 0;
+            double                                  _best = 0;
+            double                                  _best_score = 0;
+            std::vector<TYPE_PARAM>                 _best_param;
+        };
+
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        double ChessBobyqaOptimizer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::_rho_begin = 0.2;
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        double ChessBobyqaOptimizer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::_rho_end = 0.001;
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        double ChessBobyqaOptimizer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::_ply_shaping = 0.05;
+
+        // ChessBobyqaOptimizer()
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        ChessBobyqaOptimizer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::ChessBobyqaOptimizer(
+                bool evolve_white, _DomainPlayer* player, _DomainPlayer* player_opposite, BaseGame_Config cfg,
+                size_t n_opening, size_t max_f_evals, char verbose)
+        {
+            _evolve_white   = evolve_white;
+            _cfg            = cfg;
+            _n_opening      = std::max<size_t>(1, n_opening);
+            _max_f_evals    = max_f_evals;
+            _verbose        = verbose;
+
+            if (_evolve_white)
+            {
+                _player = player;
+                _player_opposite = player_opposite;
+            }
+            else
+            {
+                _player = player_opposite;
+                _player_opposite = player;
+            }
+            _player->get_root()->get_term_nodes(_player_terminal_nodes);
+        }
+
+        // setup_params() - same layout as ChessGeneticAlgorithm::setup_params()
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        void ChessBobyqaOptimizer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::setup_params()
+        {
+            _lower.clear();
+            _upper.clear();
+            _initial.clear();
+
+            std::vector<TYPE_PARAM> w;
+            for (size_t i = 0; i < _player_terminal_nodes.size(); i++)
+            {
+                w = _player_terminal_nodes[i]->get_weights();
+                for (size_t j = 0; j < w.size(); j++)
+                {
+                    _lower.push_back(-WEIGHT_BOUND);
+                    _upper.push_back(+WEIGHT_BOUND);
+                    _initial.push_back(std::max<TYPE_PARAM>(-WEIGHT_BOUND, std::min<TYPE_PARAM>(+WEIGHT_BOUND, w[j])));
+                }
+            }
+        }
+
+        // set_params()
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        void ChessBobyqaOptimizer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::set_params(const std::vector<TYPE_PARAM>& param)
+        {
+            _param = param;
+            set_node_params(_player_terminal_nodes, param);
+            _player->invalidate_eval_cache();
+        }
+
+        // set_node_params() - param in the terminal nodes of a player (or of a worker clone)
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        void ChessBobyqaOptimizer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::
+        set_node_params(const std::vector<_ConditionValuationNode*>& nodes, const std::vector<TYPE_PARAM>& param) const
+        {
+            size_t next = 0;
+            std::vector<TYPE_PARAM> w;
+            for (auto& v : nodes)
+            {
+                w = v->get_weights();
+                for (auto& vw : w) vw = param[next++];
+                v->set_weights(w);
+            }
+        }
+
+        // game_score() - score of the evolved side in [0, 1]
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        double ChessBobyqaOptimizer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::game_score(ExactScore sc, size_t ply) const
+        {
+            double shaping = (_cfg._max_game_ply > 0) ? _ply_shaping * std::min<double>(1.0, (double)ply / (double)_cfg._max_game_ply) : 0.0;
+            if (!_evolve_white)
+            {
+                if (sc == ExactScore::WIN)          sc = ExactScore::LOSS;
+                else if (sc == ExactScore::LOSS)    sc = ExactScore::WIN;
+            }
+            if (sc == ExactScore::WIN)      return 1.0 - shaping;
+            if (sc == ExactScore::LOSS)     return 0.0 + shaping;
+            if (sc == ExactScore::DRAW)     return 0.5;
+            return 0.0;
+        }
+
+        // play_openings() - games of the current point (_param) on all openings, scores in opening order
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        void ChessBobyqaOptimizer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::play_openings(std::vector<double>& ret_scores)
+        {
+            _batch->run([this](size_t worker, size_t k, _DomainPlayer& playerW, _DomainPlayer& playerB)
+            {
+                // a worker keeps its clones between games, the weights are set again for each game (cheap vs a game)
+                _DomainPlayer& p = _evolve_white ? playerW : playerB;
+                std::vector<_ConditionValuationNode*> nodes;
+                p.get_root()->get_term_nodes(nodes);
+                set_node_params(nodes, _param);
+                p.invalidate_eval_cache();
+            });
+
+            ret_scores.assign(_openings.size(), 0.0);
+            for (size_t i = 0; i < _openings.size(); i++)
+                ret_scores[i] = game_score(_batch->result(i)._score, _batch->result(i)._ply);
+        }
+
+        // objective() - minus the mean score gain over the reference games (BOBYQA minimizes)
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        double ChessBobyqaOptimizer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::objective(const column_vector& x)
+        {
+            std::vector<TYPE_PARAM> param(x.size());
+            for (long i = 0; i < x.size(); i++) param[i] = (TYPE_PARAM)x(i);
+            set_params(param);
+
+            std::vector<double> scores;
+            play_openings(scores);
+            double gain = 0;
+            for (size_t i = 0; i < scores.size(); i++) gain += scores[i] - _ref_scores[i];
+            gain /= (double)scores.size();
+
+            _n_eval++;
+            if (gain > _best)
+            {
+                _best = gain;
+                _best_param = param;
+            }
+            if (_verbose) std::cout << "bobyqa eval " << _n_eval << " gain: " << gain << " best: " << _best << std::endl;
+            return -gain;
+        }
+
+        // run()
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        double ChessBobyqaOptimizer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::run()
+        {
+            _player->attachToDomains();
+            _player_opposite->attachToDomains();
+
+            setup_params();
+            size_t n = _lower.size();
+
+            // fixed openings (white player domain as in the tournament) and reference games
+            _openings.clear();
+            _Board b;
+            for (size_t i = 0; i < _n_opening; i++)
+            {
+                if (_evolve_white)  b = _player->domain()->get_random_position(true);
+                else                b = _player_opposite->domain()->get_random_position(true);
+                _openings.push_back(b);
+            }
+
+            _batch.reset(new _GameBatch(_cfg, _pool));
+            if (_evolve_white)  _batch->add_pairing(_player, _player_opposite);
+            else                _batch->add_pairing(_player_opposite, _player);
+            for (auto& opening : _openings) _batch->add_game(opening);
+
+            set_params(_initial);
+            play_openings(_ref_scores);
+
+            _n_eval = 0;
+            _best = 0;
+            _best_param = _initial;
+
+            if (n > 0)
+            {
+                column_vector x(n), x_lower(n), x_upper(n);
+                for (size_t i = 0; i < n; i++)
+                {
+                    x(i) = _initial[i];
+                    x_lower(i) = _lower[i];
+                    x_upper(i) = _upper[i];
+                }
+                double rho_begin = _rho_begin * WEIGHT_BOUND;
+                double rho_end = std::min<double>(rho_begin, _rho_end * WEIGHT_BOUND);
+                auto f = [this](const column_vector& p) { return objective(p); };
+
+                try
+                {
+                    if (n == 1)
+                    {
+                        // BOBYQA needs at least 2 variables
+                        double x1 = x(0);
+                        dlib::find_min_single_variable([&](double v) { column_vector p(1); p(0) = v; return f(p); },
+                                                       x1, x_lower(0), x_upper(0), rho_end, (long)_max_f_evals, rho_begin);
+                    }
+                    else
+                    {
+                        dlib::find_min_bobyqa(f, x, (long)(2 * n + 1), x_lower, x_upper, rho_begin, rho_end, (long)_max_f_evals);
+                    }
+                }
+                catch (dlib::bobyqa_failure& e)
+                {
+                    // max_f_evals reached or rounding trouble: keep the best point seen
+                    if (_verbose) std::cout << "bobyqa: " << e.what() << std::endl;
+                }
+                catch (dlib::optimize_single_variable_failure& e)
+                {
+                    if (_verbose) std::cout << "bobyqa: " << e.what() << std::endl;
+                }
+            }
+
+            _batch.reset();
+            set_params(_best_param);
+
+            // the result stays here: the player ga_fitness is a tournament total, not comparable with a score gain
+            _best_score = _best;
+            for (auto& v : _ref_scores) _best_score += v / (double)_ref_scores.size();
+
+            _player->detachFromDomains();
+            _player_opposite->detachFromDomains();
+
+            _player->save();
+            _player_opposite->save();
+            return _best;
+        }
+    };
+};
+#endif
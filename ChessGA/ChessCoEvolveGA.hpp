@@ -3,8 +3,12 @@
 //                    Copyright (C) 2017 Alain Lanthier - All Rights Reserved                      
 //=================================================================================================
 //
-//  ChessGeneticAlgorithm<T, PARAM_NBIT>
+//  ChessCoEvolveGA<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>
 //
+//  Co-evolution of the W and B players. Concurrent (default): each generation, both populations are evaluated
+//  in the same phase on one task pool, against snapshots of the other side champions of the previous generation
+//  (the last one, or the last hall_of_fame() ones). Otherwise the W GA runs, then the B GA.
+//  With set_checkpoint(), both GA are saved at the end of a phase, resume() continues the concurrent run from them.
 //
 #ifndef _AL_CHESS_CHESSGA_CHESSCOEVOLVEGA_HPP
 #define _AL_CHESS_CHESSGA_CHESSCOEVOLVEGA_HPP
@@ -42,6 +46,45 @@ namespace chess
                 delete _gaB;
             }
 
+            // set_island() - island model of this process for both GA (channels distinct by GA rng_id)
+            void set_island(const IslandConfig& island)
+            {
+                _gaW->island = island;
+                _gaB->island = island;
+            }
+
+            // set_checkpoint() - checkpoint both GA every step generations (0: none)
+            void set_checkpoint(int step)
+            {
+                _gaW->set_checkpoint(step);
+                _gaB->set_checkpoint(step);
+            }
+
+            // resume() - continue the concurrent run of the 2 GA checkpoints (set_checkpoint()), false if one is missing,
+            //            invalid or of another generation than the other (then neither GA nor player is changed)
+            bool resume()
+            {
+                int nogenW, nogenB;
+                if (!_gaW->load_checkpoint(false, &nogenW) || !_gaB->load_checkpoint(false, &nogenB) || (nogenW != nogenB)) return false;
+                if (!_gaW->load_checkpoint() || !_gaB->load_checkpoint()) return false;
+
+                // hall of fame at the checkpoint: opponents of its phase, then the champions of the phase
+                _hofB = _gaW->_opponents;
+                _hofW = _gaB->_opponents;
+                push_champions();
+
+                TaskPool pool;
+                begin_concurrent(pool, false);
+                run_generations(nogenW + 1);
+                end_concurrent();
+                return true;
+            }
+
+            static bool     concurrent()                    { return _concurrent; }
+            static void     set_concurrent(bool v)          { _concurrent = v; }
+            static size_t   hall_of_fame()                  { return _hall_of_fame_size; }
+            static void     set_hall_of_fame(size_t n)      { _hall_of_fame_size = n; }
+
             void run()
             {
                 for (size_t i = 0; i < _num_iter; i++)
@@ -55,11 +98,18 @@ namespace chess
                         _playB->print_nodes();
                     }
 
-                    _gaW->setup_params();
-                    _gaW->run((i>0)?true:false);
+                    if (_concurrent)
+                    {
+                        run_concurrent((i > 0) ? true : false);
+                    }
+                    else
+                    {
+                        _gaW->setup_params();
+                        _gaW->run((i>0)?true:false);
 
-                    _gaB->setup_params();
-                    _gaB->run((i>0) ? true : false);
+                        _gaB->setup_params();
+                        _gaB->run((i > 0) ? true : false);
+                    }
 
                     if (_verbose)
                     {
@@ -97,6 +147,98 @@ namespace chess
                 }
             }
 
+        protected:
+            static bool     _concurrent;
+            static size_t   _hall_of_fame_size;             // champions kept per side as opponents (0: last champion only)
+
+            // run_concurrent() - both GA generation by generation, the 2 evaluations of a phase share the task pool
+            void run_concurrent(bool reentry)
+            {
+                TaskPool pool;
+                _gaW->setup_params();
+                _gaB->setup_params();
+
+                // current players are the first champions
+                push_champion(_hofW, _gaW->initialSet);
+                push_champion(_hofB, _gaB->initialSet);
+
+                begin_concurrent(pool, true);
+                set_opponents();
+                phase([reentry](_ChessGeneticAlgorithm* ga) { ga->init_population(reentry); });
+                push_champions();
+                checkpoint();
+                run_generations(1);
+                end_concurrent();
+            }
+
+            // begin_concurrent() - both GA on the task pool, ready to play
+            void begin_concurrent(TaskPool& pool, bool new_run)
+            {
+                _gaW->set_task_pool(&pool);
+                _gaB->set_task_pool(&pool);
+                _gaW->prepare_run(new_run);
+                _gaB->prepare_run(new_run);
+            }
+
+            // run_generations() - generations [first, nbgen], each against snapshots of the previous generation
+            void run_generations(int first)
+            {
+                for (int g = first; g <= _gaW->nbgen; g++)
+                {
+                    set_opponents();
+                    _gaW->nogen = g;
+                    _gaB->nogen = g;
+                    phase([](_ChessGeneticAlgorithm* ga) { ga->next_generation(); });
+                    push_champions();
+                    checkpoint();
+                }
+            }
+
+            void end_concurrent()
+            {
+                _gaW->finish_run();
+                _gaB->finish_run();
+                _gaW->set_task_pool(nullptr);
+                _gaB->set_task_pool(nullptr);
+                _gaW->set_opponents({});
+                _gaB->set_opponents({});
+            }
+
+            // phase() - step of both GA at the same time
+            void phase(const std::function<void(_ChessGeneticAlgorithm*)>& step)
+            {
+                std::future<void> fW = std::async(std::launch::async, [&]() { step(_gaW); });
+                step(_gaB);
+                fW.get();
+            }
+
+            // checkpoint() - state of both GA at the end of a phase
+            void checkpoint()
+            {
+                if (_gaW->checkpoint_due()) _gaW->save_checkpoint();
+                if (_gaB->checkpoint_due()) _gaB->save_checkpoint();
+            }
+
+            void set_opponents()
+            {
+                _gaW->set_opponents(_hofB);
+                _gaB->set_opponents(_hofW);
+            }
+
+            void push_champions()
+            {
+                push_champion(_hofW, _gaW->result()->decode_param());
+                push_champion(_hofB, _gaB->result()->decode_param());
+            }
+
+            void push_champion(std::vector<std::vector<TYPE_PARAM>>& hof, const std::vector<TYPE_PARAM>& param)
+            {
+                if (!hof.empty() && (hof.back() == param)) return;
+                hof.push_back(param);
+                size_t n = std::max<size_t>(1, _hall_of_fame_size);
+                if (hof.size() > n) hof.erase(hof.begin(), hof.begin() + (hof.size() - n));
+            }
+
         private:
             _DomainPlayer* _playW;
             _DomainPlayer* _playB;
@@ -107,8 +249,16 @@ namespace chess
             BaseGame_Config _cfg;
             size_t          _num_iter;
             char            _verbose;
+
+            std::vector<std::vector<TYPE_PARAM>> _hofW;    // W champions (opponents of the B GA)
+            std::vector<std::vector<TYPE_PARAM>> _hofB;    // B champions (opponents of the W GA)
         };
 
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        bool ChessCoEvolveGA<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::_concurrent = true;
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        size_t ChessCoEvolveGA<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::_hall_of_fame_size = 0;
+
     };
 };
 #endif
@@ -5,6 +5,32 @@
 //
 //  ChessGeneticAlgorithm<T, PARAM_NBIT>
 //
+// Fitness is a tournament of games. A batch of chromosomes is evaluated concurrently, each worker owns its
+// game, players and node trees (clones of the GA players). Opponents and opening positions of a chromosome
+// are drawn before the games from its own random stream (run, generation, index), so results do not depend
+// on the number of workers.
+// The games of all the tournaments of a batch are queued at once on a GameBatch (set_game_batch()): a worker sets the
+// chromosome (and opponent) weights in its clones before each game.
+//
+// Fitness cache: game results are memoized per (genome, opponent) pair, a hash of the decoded parameters of both (the
+// opponent is the genome drawn for the game, or the opposite player weights). A game of a pair already played is not
+// played again: its score is the mean of the pair previous games (with re-evaluation, a pair plays again until it has
+// that many games). The memo is kept across generations, a genome surviving (elites) or meeting the same opponents
+// (fixed opponent set or opposite player) reuses its games.
+//
+// Co-evolution (ChessCoEvolveGA): with a shared TaskPool, the games of 2 GA evaluating at the same time share the pool
+// workers (one context per pool worker). With an opponent set (snapshots of the other side champions), each game draws
+// its opponent from the set instead of playing the current opposite player.
+//
+// SPRT (set_sprt()): a tournament stops as soon as its games tell the genome from its opponents (MatchStats on single
+// games, a GA evolves one color), its fitness is the score of the games played (and reused). The fitness cache counts
+// these games. default_sprt() needs at least 8 games and floors the variance, a lucky first game decides nothing.
+//
+// Texel seed (seed_texel()): before a run, the weight_sum weights of the evolved player are fitted on TB labels (supervised,
+// clamped to the GA bounds) and seed the first chromosome, the GA refines from there.
+//
+// Checkpoint (set_checkpoint()): the GA state is completed with the fitness cache, the opponent set and the
+// terminal node weights of both players. resume() refuses a checkpoint of players with another node tree.
 //
 #ifndef _AL_CHESS_CHESSGA_CHESSGENALGO_HPP
 #define _AL_CHESS_CHESSGA_CHESSGENALGO_HPP
@@ -19,34 +45,142 @@ namespace chess
         class ChessGeneticAlgorithm : public GeneticAlgorithm<TYPE_PARAM, PARAM_NBIT>
         {
             using _ConditionValuationNode = ConditionValuationNode<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+            using _FeatureValuAlgo = FeatureValuAlgo<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+            using _FeatureValuAlgo_weight_sum = FeatureValuAlgo_weight_sum<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
             using _BaseGame = BaseGame<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+            using _GameBatch = GameBatch<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
             using _DomainPlayer = DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+            using _Board = Board<PieceID, _BoardSize>;
+            using _CHR = CHR<TYPE_PARAM, PARAM_NBIT>;
             friend class ChessCoEvolveGA<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>;
 
+            // TournamentContext - game and players of a worker (or the GA own game and players)
+            struct TournamentContext
+            {
+                _DomainPlayer*                          _player;
+                _DomainPlayer*                          _player_opposite;
+                _BaseGame*                              _game;
+                std::vector<_ConditionValuationNode*>   _player_terminal_nodes;
+                std::vector<_ConditionValuationNode*>   _player_opposite_terminal_nodes;
+            };
+
+            // TournamentPlan - games of a chromosome (opponent param empty if not single population)
+            struct TournamentGame
+            {
+                std::vector<TYPE_PARAM>                 _param_opponent;
+                _Board                                  _board;
+            };
+            struct TournamentPlan
+            {
+                std::vector<TYPE_PARAM>                 _param;
+                std::vector<TournamentGame>             _games;
+            };
+
+            // FitnessCacheEntry - all games played by a genome against one opponent
+            struct FitnessCacheEntry
+            {
+                TYPE_PARAM                              _total_fit = 0;
+                size_t                                  _n_game = 0;
+            };
+
         public:
             ChessGeneticAlgorithm(  bool evolve_white, bool is_single_pop, 
                                     _DomainPlayer* player, _DomainPlayer* player_opposite, BaseGame_Config cfg,
                                     int popsize, int nbgen, int _tournament_n_player, int _tournament_n_game, char verbose = 0);
 
             void run(bool reentry) override;
+            bool resume() override;
+
+            // set_checkpoint() - checkpoint every step generations in the persist folder of the player (0: none)
+            void set_checkpoint(int step)
+            {
+                checkpoint_step = std::max(1, step);
+                checkpoint_file = (step > 0) ? PersistManager<PieceID, _BoardSize>::instance()->get_stream_name("gacheckpoint", _player->persist_key()) : "";
+            }
 
             ~ChessGeneticAlgorithm()
             {
+                delete_worker_contexts();
                 delete _game;
             }
 
+            static bool parallel_tournament()               { return _parallel_tournament; }
+            static void set_parallel_tournament(bool v)     { _parallel_tournament = v; }
+            static bool fitness_cache()                     { return _fitness_cache_enabled; }
+            static void set_fitness_cache(bool v)           { _fitness_cache_enabled = v; }
+            static size_t fitness_reevaluate()              { return _fitness_reevaluate_max_game; }
+            static void set_fitness_reevaluate(size_t max_game) { _fitness_reevaluate_max_game = max_game; }
+
+            // set_game_batch() - games of a batch of chromosomes played by a GameBatch (not with SPRT: a tournament is played in order)
+            static void set_game_batch(bool v)              { _game_batch_enabled = v; }
+
+            // set_sprt() - a tournament stops early once SPRT decides the genome is weaker (H0) or stronger (H1) than its opponents
+            // default_sprt() - +-40 elo on single games, at least 8 games (8 straight wins or losses decide)
+            static SprtConfig default_sprt()                { return SprtConfig{ -40.0, 40.0, 0.1, 0.1, 8, 0.05 }; }
+            static void set_sprt(bool enabled, const SprtConfig& cfg = default_sprt()) { _sprt_enabled = enabled; _sprt = cfg; }
+
+            size_t      fitness_cache_hits() const          { return _fitness_cache_hits; }    // games not played (pair memoized)
+            size_t      fitness_cache_games() const;                                            // games memoized (all pairs)
+
+            // set_task_pool() - games played by the pool workers (shared with other GA), nullptr: own workers
+            void        set_task_pool(TaskPool* pool)       { _pool = pool; }
+
+            // set_opponents() - weights of the opposite player drawn per game (not single population), empty: current opposite player
+            void        set_opponents(const std::vector<std::vector<TYPE_PARAM>>& opponents) { _opponents = opponents; }
+
+            // seed_texel() - fit the weight_sum weights of the evolved player terminal nodes on their TB labelled positions
+            //                (TexelTuner, within +/-WEIGHT_BOUND), the first chromosome of the next run starts from them
+            bool        seed_texel(size_t max_samples, char verbose = 0);
+
         protected:
+            static bool     _parallel_tournament;
+            static bool     _fitness_cache_enabled;
+            static size_t   _fitness_reevaluate_max_game;   // a cached pair plays again until it has this many games (0, 1: reused after its first games)
+            static bool         _game_batch_enabled;
+            static bool         _sprt_enabled;
+            static SprtConfig   _sprt;
+
+            // run() in phases (ChessCoEvolveGA runs 2 GA generation by generation)
+            void prepare_run(bool new_run = true);          // attach players, create worker contexts
+            void init_population(bool reentry);             // create (or re-evaluate) the population
+            void next_generation();                         // evolve population one generation
+            void finish_run();                              // set best weights in player, detach, save
+
+            void write_state(std::ostream& os) const override;
+            bool read_state(std::istream& is, bool commit) override;
+
             void setup_params();
+            void create_worker_contexts();
+            void delete_worker_contexts();
 
-            void set_player_term_nodes(std::vector<_ConditionValuationNode*>& nodes, std::vector<TYPE_PARAM>& param) const
+            TournamentContext main_context() const 
+            { 
+                return TournamentContext{ _player, _player_opposite, _game, _player_terminal_nodes, _player_opposite_terminal_nodes };
+            }
+            TournamentPlan          make_plan(const std::vector<TYPE_PARAM>& param, uint64_t index) const;
+            uint64_t                opposite_player_key() const;
+            uint64_t                opening_set_key() const;
+            uint64_t                pair_key(uint64_t genome_key, const TournamentGame& g, uint64_t opposite_key, uint64_t opening_key) const;
+            std::vector<TYPE_PARAM> play_plan(TournamentContext& ctx, const TournamentPlan& plan, std::vector<TYPE_PARAM>& ret_scores) const;
+            void                    play_batch(const std::vector<TournamentPlan>& plans, std::vector<std::vector<TYPE_PARAM>>& results, std::vector<std::vector<TYPE_PARAM>>& scores) const;
+
+            // fitness_score() - score of a game for the evolved color (unfinished game: 0)
+            TYPE_PARAM fitness_score(ExactScore sc) const
+            {
+                if (sc == chess::ExactScore::DRAW) return 0.5;
+                if (sc == chess::ExactScore::WIN)  return _evolve_white ? 1.0 : 0.0;
+                if (sc == chess::ExactScore::LOSS) return _evolve_white ? 0.0 : 1.0;
+                return 0.0;
+            }
+
+            void set_player_term_nodes(std::vector<_ConditionValuationNode*>& nodes, const std::vector<TYPE_PARAM>& param) const
             {
                 size_t next = 0;
                 size_t i;
                 std::vector<TYPE_PARAM> w;
                 for (auto& v : nodes)
                 {
-                    //......................
-                    //w = v->get_weights();
+                    w = v->get_weights();
                     i = 0;
                     for (auto& vw : w)
                     {
@@ -54,8 +188,7 @@ namespace chess
                         w[i] = vw;
                         i++;
                     }
-                    //.................
-                    //v->set_weights(w);
+                    v->set_weights(w);
                 }
             }
 
@@ -63,52 +196,13 @@ namespace chess
             // tournament (as the fitness function)
             std::vector<TYPE_PARAM> tournament(bool is_at_creation, const std::vector<TYPE_PARAM>& param) const override
             {
-                std::vector<TYPE_PARAM> param_candidate = param;
-                std::vector<TYPE_PARAM> param_opponent;
-                std::vector<TYPE_PARAM> v;
-                TYPE_PARAM total_fit = 0;  
-                TYPE_PARAM score_fit = 0;
-                ExactScore sc;
-
-                set_player_term_nodes(_player_terminal_nodes, param_candidate);
-
-                for (size_t i = 0; i < _tournament_n_player; i++)
-                {
-                    for (size_t j = 0; j < _tournament_n_game; j++)
-                    {
-                       if (_is_single_pop)
-                       {
-                           size_t rnd_opponent = rand() % popsize;
-                           const std::shared_ptr<Chromosome<TYPE_PARAM, PARAM_NBIT>>& curpop_player = pop.get_cur(rnd_opponent);
-                           std::vector<TYPE_PARAM> param_opponent = curpop_player->decode_param();
-                           set_player_term_nodes(_player_opposite_terminal_nodes, param_opponent);
-                       }
-
-                       if (_evolve_white)   _game->set_board(_player->domain()->get_random_position(true));
-                       else                 _game->set_board(_player_opposite->domain()->get_random_position(true));
-
-                       sc = _game->play(false);
-                       if (_evolve_white)
-                       {
-                           if (sc == chess::ExactScore::WIN)        score_fit = 1.0;
-                           else if (sc == chess::ExactScore::LOSS)  score_fit = 0.0;
-                           else if (sc == chess::ExactScore::DRAW)  score_fit = 0.5;
-                           else score_fit = 0.0;
-                       }
-                       else
-                       {
-                           if (sc == chess::ExactScore::WIN)        score_fit = 0.0;
-                           else if (sc == chess::ExactScore::LOSS)  score_fit = 1.0;
-                           else if (sc == chess::ExactScore::DRAW)  score_fit = 0.5;
-                           else score_fit = 0.0;
-                       }
-                       total_fit += score_fit;
-                    }
-                }
-                v.push_back( total_fit / ((TYPE_PARAM)(_tournament_n_player * _tournament_n_game)) );
-                return v;
+                TournamentContext ctx = main_context();
+                std::vector<TYPE_PARAM> scores;
+                return play_plan(ctx, make_plan(param, (uint64_t)popsize), scores);    // stream index not used by a batch
             }
 
+            void evaluate_batch(std::vector<_CHR>& chrs, int begin, int end, bool is_at_creation) const override;
+
         private:
             bool _evolve_white;
             bool _is_single_pop;
@@ -121,8 +215,42 @@ namespace chess
             int                                     _tournament_n_player;
             int                                     _tournament_n_game;
             char _verbose;
+            std::vector<TournamentContext>          _worker_contexts;   // clones, one per thread (or per pool worker)
+            mutable std::unique_ptr<_GameBatch>     _batch;             // own clones per worker, made with the worker contexts
+            TaskPool*                               _pool = nullptr;
+            std::vector<std::vector<TYPE_PARAM>>    _opponents;
+
+            mutable std::map<uint64_t, FitnessCacheEntry>   _fitness_cache;     // by pair_key()
+            mutable size_t                          _fitness_cache_hits = 0;
         };
 
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        bool ChessGeneticAlgorithm<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::_parallel_tournament = true;
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        bool ChessGeneticAlgorithm<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::_fitness_cache_enabled = true;
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        size_t ChessGeneticAlgorithm<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::_fitness_reevaluate_max_game = 4;
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        bool ChessGeneticAlgorithm<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::_sprt_enabled = false;
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        bool ChessGeneticAlgorithm<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::_game_batch_enabled = true;
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        SprtConfig ChessGeneticAlgorithm<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::_sprt = ChessGeneticAlgorithm<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::default_sprt();
+
+        // hash_param() - hash of a parameter vector (bits of the values)
+        template <typename TYPE_PARAM>
+        inline uint64_t hash_param(const std::vector<TYPE_PARAM>& param, uint64_t h)
+        {
+            for (auto& v : param)
+            {
+                double d = (double)v;
+                uint64_t bits;
+                std::memcpy(&bits, &d, sizeof(bits));
+                h = hash_mix64(h ^ bits);
+            }
+            return h;
+        }
+
 
         // ChessGeneticAlgorithm()
         template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
@@ -134,6 +262,7 @@ namespace chess
             _evolve_white   = evolve_white;
             _is_single_pop  = is_single_pop;
             _cfg            = cfg;
+            this->rng_id    = _evolve_white ? 1 : 2;
 
             if (_evolve_white)
             {
@@ -175,13 +304,12 @@ namespace chess
             std::vector<TYPE_PARAM> w;
             for (int i = 0; i < _player_terminal_nodes.size(); i++)
             {
-                //...
-                //w = _player_terminal_nodes[i]->get_weights();
+                w = _player_terminal_nodes[i]->get_weights();
                 for (int j = 0; j < w.size(); j++)
                 {
                     _lowerBound.push_back(-WEIGHT_BOUND);
                     _upperBound.push_back(+WEIGHT_BOUND);
-                    _initialSet.push_back(w[j]);
+                    _initialSet.push_back(std::max<TYPE_PARAM>(-WEIGHT_BOUND, std::min<TYPE_PARAM>(+WEIGHT_BOUND, w[j])));  // trained weights may be out of bounds
                 }
             }
 
@@ -204,43 +332,542 @@ namespace chess
             this->nbparam = (int)_lowerBound.size();
         }
 
+        // seed_texel()
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        bool ChessGeneticAlgorithm<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::seed_texel(size_t max_samples, char verbose)
+        {
+            _player->attachToDomains();
+
+            bool ok = true;
+            size_t n_tuned = 0;
+            for (auto& node : _player_terminal_nodes)
+            {
+                _FeatureValuAlgo* algo = node->current_valu_algo();
+                if ((algo == nullptr) || (algo->cfg()._name != FeatureBasedAlgoName::valu_weight_sum)) continue;
+
+                if (FeatureTexelTuner<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::tune(*_player, node, *(_FeatureValuAlgo_weight_sum*)algo, max_samples, verbose, (double)WEIGHT_BOUND))
+                    n_tuned++;
+                else
+                    ok = false;     // node kept its weights
+            }
+            _player->invalidate_eval_cache();
+            if (verbose) std::cout << "texel seed: " << n_tuned << "/" << _player_terminal_nodes.size() << " terminal nodes" << std::endl;
+
+            setup_params();         // initial set from the tuned weights
+            return ok;
+        }
+
+        // create_worker_contexts() - one per thread, clones of the players at this time (none if single thread)
+        //                            one per pool worker with a task pool
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        void ChessGeneticAlgorithm<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::create_worker_contexts()
+        {
+            delete_worker_contexts();
+
+            unsigned concurrency = _parallel_tournament ? std::thread::hardware_concurrency() : 1;
+            size_t n = (_pool != nullptr) ? _pool->size() : std::min<size_t>(concurrency, (size_t)popsize);
+            if ((_pool == nullptr) && (n < 2)) return;
+            for (size_t w = 0; w < n; w++)
+            {
+                TournamentContext ctx;
+                ctx._player = _player->clone();
+                ctx._player_opposite = _player_opposite->clone();
+                if (_evolve_white)  ctx._game = new _BaseGame(*ctx._player, *ctx._player_opposite);
+                else                ctx._game = new _BaseGame(*ctx._player_opposite, *ctx._player);
+                ctx._game->set_constraints(_cfg);
+                ctx._player->get_root()->get_term_nodes(ctx._player_terminal_nodes);
+                ctx._player_opposite->get_root()->get_term_nodes(ctx._player_opposite_terminal_nodes);
+                _worker_contexts.push_back(ctx);
+            }
+
+            _batch.reset(new _GameBatch(_cfg, _pool));
+            if (_evolve_white)  _batch->add_pairing(_player, _player_opposite);
+            else                _batch->add_pairing(_player_opposite, _player);
+        }
+
+        // delete_worker_contexts()
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        void ChessGeneticAlgorithm<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::delete_worker_contexts()
+        {
+            for (auto& ctx : _worker_contexts)
+            {
+                delete ctx._game;
+                delete ctx._player;
+                delete ctx._player_opposite;
+            }
+            _worker_contexts.clear();
+            _batch.reset();
+        }
+
+        // make_plan() - draw the opponents and the initial positions of the tournament of param (stream of chromosome index)
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        typename ChessGeneticAlgorithm<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::TournamentPlan 
+        ChessGeneticAlgorithm<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::make_plan(const std::vector<TYPE_PARAM>& param, uint64_t index) const
+        {
+            RngScope rng_scope(this->rng_stream(RngStreamId::ga_tournament, index));
+            TournamentPlan plan;
+            plan._param = param;
+            for (size_t i = 0; i < _tournament_n_player; i++)
+            {
+                for (size_t j = 0; j < _tournament_n_game; j++)
+                {
+                    TournamentGame g;
+                    if (_is_single_pop)
+                    {
+                        size_t rnd_opponent = (size_t)thread_rng().below(popsize);
+                        const std::shared_ptr<Chromosome<TYPE_PARAM, PARAM_NBIT>>& curpop_player = pop.get_cur(rnd_opponent);
+                        g._param_opponent = curpop_player->decode_param();
+                    }
+                    else if (!_opponents.empty())
+                    {
+                        size_t rnd_opponent = (_opponents.size() > 1) ? (size_t)thread_rng().below(_opponents.size()) : 0;
+                        g._param_opponent = _opponents[rnd_opponent];
+                    }
+
+                    if (_evolve_white)  g._board = _player->domain()->get_random_position(true);
+                    else                g._board = _player_opposite->domain()->get_random_position(true);
+                    plan._games.push_back(g);
+                }
+            }
+            return plan;
+        }
+
+        // play_plan() - fitness of the plan games on the context players, ret_scores: score of the games played in plan order
+        //               (with SPRT, the games left are not played once the genome is decided weaker or stronger)
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        std::vector<TYPE_PARAM> ChessGeneticAlgorithm<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::
+        play_plan(TournamentContext& ctx, const TournamentPlan& plan, std::vector<TYPE_PARAM>& ret_scores) const
+        {
+            std::vector<TYPE_PARAM> v;
+            TYPE_PARAM total_fit = 0;
+            TYPE_PARAM score_fit = 0;
+            ExactScore sc;
+            _Board board;
+            MatchStats stats;
+            ret_scores.clear();
+
+            set_player_term_nodes(ctx._player_terminal_nodes, plan._param);
+            ctx._player->invalidate_eval_cache();
+
+            for (auto& g : plan._games)
+            {
+                if (!g._param_opponent.empty())
+                {
+                    set_player_term_nodes(ctx._player_opposite_terminal_nodes, g._param_opponent);
+                    ctx._player_opposite->invalidate_eval_cache();
+                }
+
+                board = g._board;
+                ctx._game->set_board(board);
+                sc = ctx._game->play(false);
+                score_fit = fitness_score(sc);
+                total_fit += score_fit;
+                ret_scores.push_back(score_fit);
+
+                if (_sprt_enabled)
+                {
+                    stats.add_game((double)score_fit);
+                    if (stats.sprt(_sprt) != SprtResult::none) break;
+                }
+            }
+            v.push_back( (ret_scores.size() > 0) ? total_fit / (TYPE_PARAM)ret_scores.size() : 0 );
+            return v;
+        }
+
+        // play_batch() - games of all plans in one GameBatch, a worker sets the weights of the plan in its clones before a game
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        void ChessGeneticAlgorithm<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::
+        play_batch(const std::vector<TournamentPlan>& plans, std::vector<std::vector<TYPE_PARAM>>& results, std::vector<std::vector<TYPE_PARAM>>& scores) const
+        {
+            std::vector<size_t>                 plan_of_game;
+            std::vector<const TournamentGame*>  games;
+            _batch->clear();
+            for (size_t k = 0; k < plans.size(); k++)
+            {
+                for (auto& g : plans[k]._games)
+                {
+                    _batch->add_game(g._board, 0);
+                    plan_of_game.push_back(k);
+                    games.push_back(&g);
+                }
+            }
+
+            // per worker: terminal nodes of its clones, plan of the weights set in its GA player clone
+            size_t nworker = _batch->nworker();
+            std::vector<std::vector<_ConditionValuationNode*>> nodes(nworker);
+            std::vector<std::vector<_ConditionValuationNode*>> nodes_opposite(nworker);
+            std::vector<size_t> cur_plan(nworker, plans.size());
+            _batch->run([&](size_t w, size_t i, _DomainPlayer& playerW, _DomainPlayer& playerB)
+            {
+                _DomainPlayer& player = _evolve_white ? playerW : playerB;
+                _DomainPlayer& opposite = _evolve_white ? playerB : playerW;
+                if (nodes[w].empty())
+                {
+                    player.get_root()->get_term_nodes(nodes[w]);
+                    opposite.get_root()->get_term_nodes(nodes_opposite[w]);
+                }
+                if (cur_plan[w] != plan_of_game[i])
+                {
+                    cur_plan[w] = plan_of_game[i];
+                    set_player_term_nodes(nodes[w], plans[cur_plan[w]]._param);
+                    player.invalidate_eval_cache();
+                }
+                if (!games[i]->_param_opponent.empty())
+                {
+                    set_player_term_nodes(nodes_opposite[w], games[i]->_param_opponent);
+                    opposite.invalidate_eval_cache();
+                }
+            });
+
+            std::vector<TYPE_PARAM> total_fit(plans.size(), 0);
+            scores.assign(plans.size(), std::vector<TYPE_PARAM>());
+            for (size_t i = 0; i < games.size(); i++)
+            {
+                TYPE_PARAM score_fit = fitness_score(_batch->result(i)._score);
+                total_fit[plan_of_game[i]] += score_fit;
+                scores[plan_of_game[i]].push_back(score_fit);       // games of a plan are in plan order
+            }
+            for (size_t k = 0; k < plans.size(); k++)
+                results[k] = std::vector<TYPE_PARAM>(1, (scores[k].size() > 0) ? total_fit[k] / (TYPE_PARAM)scores[k].size() : 0);
+        }
+
+        // opposite_player_key() - hash of the opposite player weights (opponent of the games without a drawn opponent)
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        uint64_t ChessGeneticAlgorithm<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::opposite_player_key() const
+        {
+            uint64_t h = hash_mix64(2);
+            for (auto& node : _player_opposite_terminal_nodes)
+                h = hash_param(node->get_weights(), h);
+            return h;
+        }
+
+        // opening_set_key() - set the openings are drawn from: random positions of the white player domain under the master seed
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        uint64_t ChessGeneticAlgorithm<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::opening_set_key() const
+        {
+            const _DomainPlayer* playerW = _evolve_white ? _player : _player_opposite;
+            return hash_mix64(hash_string64(playerW->domain()->domain_key()) ^ RngMaster::seed());
+        }
+
+        // pair_key() - memo key of a game: genome, its opponent (drawn genome, or opposite player) and the opening set
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        uint64_t ChessGeneticAlgorithm<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::
+        pair_key(uint64_t genome_key, const TournamentGame& g, uint64_t opposite_key, uint64_t opening_key) const
+        {
+            uint64_t h = g._param_opponent.empty() ? hash_mix64(genome_key ^ opposite_key) : hash_param(g._param_opponent, genome_key);
+            return hash_mix64(h ^ opening_key);
+        }
+
+        // fitness_cache_games()
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        size_t ChessGeneticAlgorithm<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::fitness_cache_games() const
+        {
+            size_t n = 0;
+            for (auto& e : _fitness_cache) n += e.second._n_game;
+            return n;
+        }
+
+        // evaluate_batch() - plans drawn serially, games played by the workers, results set in chromosome order
+        //                    (a game of a memoized pair, or a genome already in the batch, is not played)
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        void ChessGeneticAlgorithm<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::
+        evaluate_batch(std::vector<_CHR>& chrs, int begin, int end, bool is_at_creation) const
+        {
+            if (end <= begin) return;
+
+            uint64_t opposite_key = _fitness_cache_enabled ? opposite_player_key() : 0;
+            uint64_t opening_key = _fitness_cache_enabled ? opening_set_key() : 0;
+
+            std::vector<TournamentPlan>         plans;                          // games to play
+            std::vector<std::vector<uint64_t>>  plan_game_keys;                 // pair key of each game to play
+            std::vector<size_t>                 plan_of(end - begin, 0);        // plan of the chromosome
+            std::vector<int>                    same_as(end - begin, -1);       // first chromosome of the batch with this genome
+            std::vector<TYPE_PARAM>             reused_fit(end - begin, 0);     // games of memoized pairs
+            std::vector<size_t>                 reused_n(end - begin, 0);
+            std::map<uint64_t, int>             planned;
+            size_t min_game = std::max<size_t>(1, _fitness_reevaluate_max_game);
+            for (int i = begin; i < end; i++)
+            {
+                const std::vector<TYPE_PARAM>& param = chrs[i]->decode();
+                TournamentPlan plan = make_plan(param, i);
+                if (!_fitness_cache_enabled)
+                {
+                    plan_of[i - begin] = plans.size();
+                    plans.push_back(plan);
+                    continue;
+                }
+
+                uint64_t genome_key = hash_param(param, hash_mix64(1));
+                auto it_planned = planned.find(genome_key);
+                if (it_planned != planned.end())
+                {
+                    same_as[i - begin] = it_planned->second;
+                    _fitness_cache_hits += plan._games.size();
+                    continue;
+                }
+                planned[genome_key] = i - begin;
+
+                TournamentPlan to_play;
+                std::vector<uint64_t> keys;
+                to_play._param = param;
+                for (auto& g : plan._games)
+                {
+                    uint64_t key = pair_key(genome_key, g, opposite_key, opening_key);
+                    auto it = _fitness_cache.find(key);
+                    if ((it != _fitness_cache.end()) && (it->second._n_game >= min_game))
+                    {
+                        reused_fit[i - begin] += it->second._total_fit / (TYPE_PARAM)it->second._n_game;
+                        reused_n[i - begin]++;
+                        _fitness_cache_hits++;
+                        continue;
+                    }
+                    to_play._games.push_back(g);
+                    keys.push_back(key);
+                }
+                plan_of[i - begin] = plans.size();
+                plans.push_back(to_play);
+                plan_game_keys.push_back(keys);
+            }
+
+            // workers only play with clones: invalidate_eval_cache() of a GA player also resets its children players,
+            // shared by all workers to evaluate the children domains
+            std::vector<std::vector<TYPE_PARAM>> results(plans.size());
+            std::vector<std::vector<TYPE_PARAM>> scores(plans.size());
+            size_t nworker = std::min<size_t>(_worker_contexts.size(), plans.size());
+            if (_game_batch_enabled && !_sprt_enabled && (_batch != nullptr))
+            {
+                play_batch(plans, results, scores);
+            }
+            else if (_pool != nullptr)
+            {
+                std::vector<TournamentContext> contexts(_worker_contexts.begin(), _worker_contexts.end());
+                _pool->run(plans.size(), [&](size_t w, size_t k)
+                {
+                    results[k] = play_plan(contexts[w], plans[k], scores[k]);
+                });
+            }
+            else if (!_parallel_tournament || (nworker < 2))
+            {
+                TournamentContext ctx = main_context();
+                for (size_t k = 0; k < plans.size(); k++)
+                    results[k] = play_plan(ctx, plans[k], scores[k]);
+            }
+            else
+            {
+                std::vector<TournamentContext> contexts(_worker_contexts.begin(), _worker_contexts.begin() + nworker);
+                std::atomic<size_t> next_task(0);
+                std::vector<std::future<void>> fut;
+                for (size_t w = 0; w < contexts.size(); w++)
+                {
+                    fut.push_back(std::async(std::launch::async, [&, w]()
+                    {
+                        for (size_t k = next_task++; k < plans.size(); k = next_task++)
+                            results[k] = play_plan(contexts[w], plans[k], scores[k]);
+                    }));
+                }
+                for (auto& f : fut) f.get();
+            }
+
+            if (!_fitness_cache_enabled)
+            {
+                for (int i = begin; i < end; i++)
+                    chrs[i]->set_result(results[plan_of[i - begin]]);
+                return;
+            }
+
+            // games played memoized by pair (SPRT: the games of the plan prefix played)
+            for (size_t k = 0; k < plans.size(); k++)
+            {
+                for (size_t j = 0; j < scores[k].size(); j++)
+                {
+                    FitnessCacheEntry& e = _fitness_cache[plan_game_keys[k][j]];
+                    e._total_fit += scores[k][j];
+                    e._n_game++;
+                }
+            }
+
+            // fitness: mean of the games played and of the memoized pairs games
+            std::vector<TYPE_PARAM> v(1);
+            for (int i = begin; i < end; i++)
+            {
+                int first = (same_as[i - begin] >= 0) ? same_as[i - begin] : i - begin;
+                const std::vector<TYPE_PARAM>& played = scores[plan_of[first]];
+                TYPE_PARAM total = reused_fit[first];
+                for (auto& sc : played) total += sc;
+                size_t n = reused_n[first] + played.size();
+                v[0] = (n > 0) ? total / (TYPE_PARAM)n : 0;
+                chrs[i]->set_result(v);
+            }
+        }
+
         // run()
         template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
         void ChessGeneticAlgorithm<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::run(bool reentry)
+        {
+            prepare_run();
+            init_population(reentry);
+            for (nogen = 1; nogen <= nbgen; ++nogen)
+            {
+                next_generation();
+                if (checkpoint_due()) save_checkpoint();
+            }
+            finish_run();
+        }
+
+        // resume() - continue the run of the checkpoint (players weights restored before their worker clones are made)
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        bool ChessGeneticAlgorithm<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::resume()
+        {
+            if (checkpoint_file.empty()) return false;
+            if (!load_checkpoint()) return false;
+
+            prepare_run(false);
+            for (nogen = nogen + 1; nogen <= nbgen; ++nogen)
+            {
+                next_generation();
+                if (checkpoint_due()) save_checkpoint();
+            }
+            finish_run();
+            return true;
+        }
+
+        // prepare_run()
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        void ChessGeneticAlgorithm<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::prepare_run(bool new_run)
         {
             _player->attachToDomains();
             _player_opposite->attachToDomains();
+            create_worker_contexts();
 
             this->check();
+            if (new_run) ++norun;
+            setup_island();
+        }
+
+        // init_population()
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        void ChessGeneticAlgorithm<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::init_population(bool reentry)
+        {
+            nogen = 0;
             if (!reentry)
             {
                 pop = Population<TYPE_PARAM, PARAM_NBIT>(*this);
-                pop.creation(false, true);                          // setup all chromo then evaluate() them
+                pop.creation(false, true);                          // setup all chromo then evaluate_batch() them
             }
             else
             {
-                pop(0)->evaluate();
+                std::vector<_CHR> best{ pop.get_cur(0) };           // re-evaluated against the current opponents
+                evaluate_batch(best, 0, 1, false);
             }
-            TYPE_PARAM bestResult = pop(0)->getTotal();
+            history.assign(1, pop(0)->getTotal());
+        }
 
-            for (nogen = 1; nogen <= nbgen; ++nogen)
+        // next_generation()
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        void ChessGeneticAlgorithm<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::next_generation()
+        {
+            pop.evolution();                                        // evaluate_batch() called in recombination, completion
+            if (island.enabled() && (nogen % island.interval == 0))
+                migration();                                        // island model: migrants evaluated in this island
+            history.push_back(pop(0)->getTotal());
+        }
+
+        // write_state() - fitness cache, opponent set, players terminal node weights
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        void ChessGeneticAlgorithm<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::write_state(std::ostream& os) const
+        {
+            write_pod(os, (uint64_t)_fitness_cache_hits);
+            write_pod(os, (uint64_t)_fitness_cache.size());
+            for (auto& e : _fitness_cache)
+            {
+                write_pod(os, e.first);
+                write_pod(os, e.second._total_fit);
+                write_pod(os, (uint64_t)e.second._n_game);
+            }
+
+            write_pod(os, (uint64_t)_opponents.size());
+            for (auto& param : _opponents) write_vector(os, param);
+
+            for (auto nodes : { &_player_terminal_nodes, &_player_opposite_terminal_nodes })
             {
-                pop.evolution();                                    // evaluate() called in recombination, completion newpop[i]->evaluate()
-                bestResult = pop(0)->getTotal();
+                write_pod(os, (uint64_t)nodes->size());
+                for (auto& node : *nodes) write_vector(os, node->get_weights());
             }
+        }
 
+        // read_state() - false if the players do not have the node trees of the checkpoint
+        //                (read into temporaries, the GA and its players are only changed when the whole state is valid and commit)
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        bool ChessGeneticAlgorithm<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::read_state(std::istream& is, bool commit)
+        {
+            uint64_t hits, n;
+            std::map<uint64_t, FitnessCacheEntry> cache;
+            if (!read_pod(is, hits) || !read_pod(is, n)) return false;
+            for (uint64_t i = 0; i < n; i++)
+            {
+                uint64_t key, n_game;
+                FitnessCacheEntry e;
+                if (!read_pod(is, key) || !read_pod(is, e._total_fit) || !read_pod(is, n_game)) return false;
+                e._n_game = (size_t)n_game;
+                cache[key] = e;
+            }
+
+            std::vector<std::vector<TYPE_PARAM>> opponents;
+            if (!read_pod(is, n)) return false;
+            opponents.assign((size_t)n, std::vector<TYPE_PARAM>());
+            for (auto& param : opponents)
+                if (!read_vector(is, param, (uint64_t)nbparam)) return false;
+
+            std::vector<std::vector<TYPE_PARAM>> weights[2];
+            std::vector<_ConditionValuationNode*>* nodes[2] = { &_player_terminal_nodes, &_player_opposite_terminal_nodes };
+            for (int k = 0; k < 2; k++)
+            {
+                if (!read_pod(is, n) || (n != nodes[k]->size())) return false;
+                weights[k].resize((size_t)n);
+                for (size_t i = 0; i < n; i++)
+                {
+                    if (!read_vector(is, weights[k][i], 1 << 20)) return false;
+                    if (weights[k][i].size() != (*nodes[k])[i]->get_weights().size()) return false;
+                }
+            }
+            if (!commit) return true;
+
+            _fitness_cache_hits = (size_t)hits;
+            _fitness_cache.swap(cache);
+            _opponents.swap(opponents);
+            for (int k = 0; k < 2; k++)
+                for (size_t i = 0; i < weights[k].size(); i++)
+                    (*nodes[k])[i]->set_weights(weights[k][i]);
+            _player->invalidate_eval_cache();
+            _player_opposite->invalidate_eval_cache();
+            return true;
+        }
+
+        // finish_run()
+        template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, int WEIGHT_BOUND>
+        void ChessGeneticAlgorithm<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT, WEIGHT_BOUND>::finish_run()
+        {
             const std::shared_ptr<Chromosome<TYPE_PARAM, PARAM_NBIT>>& best_player = pop.get_cur(0);
             std::vector<TYPE_PARAM> param_best = best_player->decode_param();
             set_player_term_nodes(_player_terminal_nodes, param_best);
+            _player->invalidate_eval_cache();
 
             _player->set_ga_instance(0);
-            _player->set_ga_fitness(bestResult);
+            _player->set_ga_fitness(best_player->getTotal());
 
+            if ((_verbose > 0) && _fitness_cache_enabled)
+                std::cout << "GA fitness cache hits: " << _fitness_cache_hits << std::endl;
+
+            delete_worker_contexts();
             _player->detachFromDomains();
             _player_opposite->detachFromDomains();
 
-            _player->save();
-            _player_opposite->save();
+            // island model: island 0 persists the players (others contribute through their migrants)
+            if (!island.enabled() || (island.island == 0))
+            {
+                _player->save();
+                _player_opposite->save();
+            }
         }
 
     };
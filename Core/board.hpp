@@ -60,6 +60,7 @@ namespace chess
         uint16_t cnt_piece(PieceName n, PieceColor c) const;
         uint16_t cnt_piece(PieceID)  const;
         std::vector<PieceID> get_piecesID() const;
+        uint64_t get_hash_key() const;             // Zobrist key (cells, color to play, castling/ep state)
         std::vector<uint16_t> get_square_of_pieces() const;
         uint8_t on_edge(PieceName n, PieceColor c) const;
         uint8_t dist(PieceName n, PieceColor c, PieceName n2, PieceColor c2) const;
@@ -1005,9 +1006,9 @@ namespace chess
         uint8_t bK = 0;
         while ((wK == bK) || (wK == wQ) || (bK == wQ))
         {
-            wQ = (std::rand() % (_BoardSize*_BoardSize));
-            wK = (std::rand() % (_BoardSize*_BoardSize));
-            bK = (std::rand() % (_BoardSize*_BoardSize));
+            wQ = (uint8_t)thread_rng().below(_BoardSize*_BoardSize);
+            wK = (uint8_t)thread_rng().below(_BoardSize*_BoardSize);
+            bK = (uint8_t)thread_rng().below(_BoardSize*_BoardSize);
             n++;
             if (n > 100)
             {
@@ -1049,9 +1050,9 @@ namespace chess
         while ((wK == bK) || (wK == wP) || (bK == wP) || (((uint8_t)(wP / _BoardSize)) == (_BoardSize - 1)) || (((uint8_t)(wP / _BoardSize)) == (0)))
         {
             // use std::mt19937_64 ...
-            wP = (std::rand() % (_BoardSize*_BoardSize));
-            wK = (std::rand() % (_BoardSize*_BoardSize));
-            bK = (std::rand() % (_BoardSize*_BoardSize));
+            wP = (uint8_t)thread_rng().below(_BoardSize*_BoardSize);
+            wK = (uint8_t)thread_rng().below(_BoardSize*_BoardSize);
+            bK = (uint8_t)thread_rng().below(_BoardSize*_BoardSize);
             n++;
             if (n > 100)
             {
@@ -1096,10 +1097,10 @@ namespace chess
                 (((uint8_t)(wP / _BoardSize)) == (_BoardSize - 1)) || (((uint8_t)(wP / _BoardSize)) == (0)) ||
                 (((uint8_t)(bP / _BoardSize)) == (_BoardSize - 1)) || (((uint8_t)(bP / _BoardSize)) == (0)))
         {
-            wP = (std::rand() % (_BoardSize*_BoardSize));
-            wK = (std::rand() % (_BoardSize*_BoardSize));
-            bK = (std::rand() % (_BoardSize*_BoardSize));
-            bP = (std::rand() % (_BoardSize*_BoardSize));
+            wP = (uint8_t)thread_rng().below(_BoardSize*_BoardSize);
+            wK = (uint8_t)thread_rng().below(_BoardSize*_BoardSize);
+            bK = (uint8_t)thread_rng().below(_BoardSize*_BoardSize);
+            bP = (uint8_t)thread_rng().below(_BoardSize*_BoardSize);
             n++;
             if (n > 100)
             {
@@ -1155,6 +1156,38 @@ namespace chess
         return false;
     }
 
+    // get_hash_key() - Zobrist keys are fixed (deterministic seed) so keys are stable across runs
+    template <typename PieceID, typename uint8_t _BoardSize>
+    inline uint64_t Board<PieceID, _BoardSize>::get_hash_key() const
+    {
+        const size_t NID = 32;  // max PieceID keyed per square
+        static const std::vector<uint64_t> zobrist = []()
+        {
+            std::mt19937_64 g(0x5A0B5157ULL);
+            std::vector<uint64_t> v(_BoardSize * _BoardSize * NID + 1 + 4 + 16);
+            for (auto& k : v) k = g();
+            return v;
+        }();
+
+        uint64_t key = 0;
+        for (size_t i = 0; i < _cells.size(); i++)
+        {
+            if (_cells[i] != _Piece::empty_id())
+            {
+                assert((size_t)_cells[i] < NID);
+                key ^= zobrist[i * NID + (size_t)_cells[i]];
+            }
+        }
+        if (_color_toplay == PieceColor::B) key ^= zobrist[_BoardSize * _BoardSize * NID];
+        if (_history_moves.size() > 0)
+        {
+            const _Move& mv = _history_moves.back();
+            for (size_t i = 0; i < 4; i++)  if (!mv.state_castling[i]) key ^= zobrist[_BoardSize * _BoardSize * NID + 1 + i];
+            for (size_t i = 0; i < 16; i++) if (!mv.state_ep[i])       key ^= zobrist[_BoardSize * _BoardSize * NID + 5 + i];
+        }
+        return key;
+    }
+
     template <typename PieceID, typename uint8_t _BoardSize>
     bool Board<PieceID, _BoardSize>::is_last_move_pawn() const
     {
@@ -19,6 +19,9 @@
 #include <list>
 #include <future>
 #include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
 #include <thread>
 #include <conio.h>
 #include <bitset>
@@ -26,6 +29,10 @@
 #include <array>
 #include <set>
 #include <random>
+#include <algorithm>
+#include <chrono>
+#include <atomic>
+#include <cstring>
 
 namespace chess
 {
@@ -40,7 +47,12 @@ namespace chess
     template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT> class BasePlayer;
     template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT> class PlayerFactory;
     template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT> class ConditionValuationNode;
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT> class CondValuNodeProgram;
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT> class FeatureDatasetBuilder;
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT> class FeatureMatrixCache;
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT> class FeatureTexelTuner;
     template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT> class FeatureManager;
+    template <typename PieceID, typename uint8_t _BoardSize> class FeatureContext;
     template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT> class ConditionFeature;
     template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT> class ValuationFeature;
     template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT> class ValuationFeature_numberMoveForPiece;
@@ -51,6 +63,8 @@ namespace chess
 
     template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT> class GameDB;
     template <typename PieceID, typename uint8_t _BoardSize> struct GameDB_Record;
+    template <typename PieceID, typename uint8_t _BoardSize> struct SelfPlaySample;
+    template <typename PieceID, typename uint8_t _BoardSize> class SelfPlayStore;
 
     template <typename PieceID, typename uint8_t _BoardSize> class PieceSet;
     template <typename PieceID, typename uint8_t _BoardSize> class TBH_Base;
@@ -61,20 +75,26 @@ namespace chess
     template <typename PieceID, typename uint8_t _BoardSize> struct STRUCT_TBH;
     template <typename PieceID, typename uint8_t _BoardSize, uint8_t NPIECE> class TBH_Symmetry;
     template <typename PieceID, typename uint8_t _BoardSize> class TablebaseBase;
+    template <typename PieceID, typename uint8_t _BoardSize> class TB_Manager;
     template <typename PieceID, typename uint8_t _BoardSize> struct STRUCT_PIECE_RANK;
 
     template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT> class FeatureValuAlgo;
     template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT> class FeatureAlgo;
     template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT> class FeatureCondAlgo;
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT> class FeatureValuAlgo_svm_c_linear_dcd_trainer;
     template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT> struct FeatureAlgoConfig;
 }
 
 #include "core/util.hpp"
+#include "core/rng.hpp"
+#include "core/task_pool.hpp"
 #include "core/move.hpp"
 #include "core/piece.hpp"
 #include "core/board.hpp"
 #include "unittest/unittest.hpp"
 #include "unittest/testboard.hpp"
+#include "player/searchstats.hpp"
+#include "player/evalcache.hpp"
 #include "player/playerbase.hpp"
 #include "player/player.hpp"
 #include "player/playerfactory.hpp"
@@ -84,20 +104,31 @@ namespace chess
 #include "domain/partitionmanager.hpp"
 #include "persistence/persist.hpp"
 #include "feature/basefeature.hpp"
+#include "feature/feature_context.hpp"
 #include "feature/feature.hpp"
 #include "feature/featuremanager.hpp"
 #include "feature/node_changer.hpp"
 #include "feature/feature_algo_cfg.hpp"
 #include "feature/feature_algo.hpp"
 #include "feature/feature_algo_cond_product_boolean.hpp"
+#include "feature/feature_batch_eval.hpp"
 #include "feature/feature_algo_valu_weight_sum.hpp"
+#include "feature/feature_dataset.hpp"
+#include "feature/feature_matrix_cache.hpp"
+#include "feature/feature_texel_tuner.hpp"
 #include "feature/feature_algo_valu_rvm_trainer.hpp"
+#include "feature/feature_algo_valu_svm_c_linear_dcd_trainer.hpp"
 #include "feature/condvalunode.hpp"
+#include "feature/condvalunode_program.hpp"
 #include "game/game.hpp"
 #include "game/gamedb.hpp"
+#include "game/gamebatch.hpp"
+#include "game/match.hpp"
+#include "game/selfplay.hpp"
 #include "ga/galgo_example.hpp"
 #include "ChessGA/ChessGenAlgo.hpp"
 #include "ChessGA/ChessCoEvolveGA.hpp"
+#include "ChessGA/ChessBobyqa.hpp"
 #include "Tablebase/TB.hpp"
 #include "Tablebase/symTB.hpp"
 #include "Tablebase/pieceset.hpp"
@@ -121,6 +121,14 @@ namespace chess
 
         std::string to_str() const;
 
+        // same move from the same position (ignoring the board state copied into the move)
+        bool is_same(const Move& m) const
+        {
+            return  (src_x == m.src_x) && (src_y == m.src_y) && (dst_x == m.dst_x) && (dst_y == m.dst_y) &&
+                    (prev_src_id == m.prev_src_id) && (prev_dst_id == m.prev_dst_id) &&
+                    (mu.context_extra == m.mu.context_extra);
+        }
+
         bool get_state_castling(const PieceColor c, const PieceName side) const
         {
             if      ((c == PieceColor::W) && (side == PieceName::K)) return state_castling[0];
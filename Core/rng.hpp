@@ -0,0 +1,118 @@
+#pragma once
+//=================================================================================================
+//                    Copyright (C) 2017 Alain Lanthier - All Rights Reserved                      
+//=================================================================================================
+//
+// CounterRng   : counter based random generator, value i of a stream is a hash of (stream key, i)
+// RngMaster    : master seed, root of all stream keys
+// RngScope     : binds a stream to the calling thread for the scope (thread_rng())
+//
+// A stream key is derived from the master seed and a path of ids (Ex: GA run/generation/chromosome),
+// a value only depends on (master seed, ids, position in the stream): no shared generator state and
+// the same draws whatever the number of threads or their scheduling.
+//
+#ifndef _AL_CHESS_CORE_RNG_HPP
+#define _AL_CHESS_CORE_RNG_HPP
+
+namespace chess
+{
+    // RngStreamId - first id of a stream path
+    enum class RngStreamId : uint64_t { thread_default = 1, ga_creation, ga_selection, ga_crossover, ga_completion, ga_tournament, ga, ga_migration, match, selfplay, texel };
+
+    // CounterRng
+    class CounterRng
+    {
+    public:
+        typedef uint64_t result_type;
+
+        explicit CounterRng(uint64_t key = 0, uint64_t counter = 0) : _key(key), _counter(counter) {}
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return UINT64_MAX; }
+
+        // operator() - next value (UniformRandomBitGenerator, usable with std distributions)
+        result_type operator()() { return hash_mix64(hash_mix64(_counter++) ^ _key); }
+
+        // uniform_double() - [0,1) with 53 bits
+        double uniform_double() { return (double)((*this)() >> 11) * (1.0 / 9007199254740992.0); }
+
+        // uniform() - [min, max)
+        template <typename T>
+        T uniform(T min, T max) { return (T)(min + uniform_double() * (max - min)); }
+
+        // below() - unbiased [0, n), n = 0 is the full 64 bits range
+        uint64_t below(uint64_t n)
+        {
+            if (n == 0) return (*this)();
+            uint64_t rem = (UINT64_MAX % n + 1) % n;    // 2^64 mod n values rejected
+            uint64_t r;
+            do { r = (*this)(); } while (r > UINT64_MAX - rem);
+            return r % n;
+        }
+
+        // stream() - independent child stream
+        CounterRng stream(uint64_t id) const { return CounterRng(hash_mix64(_key ^ hash_mix64(id ^ 0xD1B54A32D192ED03ULL))); }
+        CounterRng stream(RngStreamId id) const { return stream((uint64_t)id); }
+
+        uint64_t key()      const { return _key; }
+        uint64_t counter()  const { return _counter; }
+
+    private:
+        uint64_t _key;
+        uint64_t _counter;
+    };
+
+    // RngMaster - set the seed before the first draw for a reproducible run
+    class RngMaster
+    {
+    public:
+        static uint64_t     seed()                  { return seed_value(); }
+        static void         set_seed(uint64_t s)    { seed_value() = s; }
+        static CounterRng   stream(RngStreamId id)  { return CounterRng(seed_value()).stream(id); }
+
+    private:
+        // seed_value() - one seed in the program (header only: no out of class static definition), random until set
+        static uint64_t& seed_value()
+        {
+            static uint64_t seed = ((uint64_t)std::random_device()() << 32) ^ (uint64_t)std::random_device()();
+            return seed;
+        }
+    };
+
+    inline CounterRng*& thread_rng_binding()
+    {
+        static thread_local CounterRng* rng = nullptr;
+        return rng;
+    }
+
+    // thread_rng() - stream bound by the innermost RngScope of the thread, else a default stream of the thread
+    inline CounterRng& thread_rng()
+    {
+        CounterRng* rng = thread_rng_binding();
+        if (rng != nullptr) return *rng;
+
+        static std::atomic<uint64_t> thread_counter(0);
+        static thread_local CounterRng default_rng = RngMaster::stream(RngStreamId::thread_default).stream(thread_counter++);
+        return default_rng;
+    }
+
+    // RngScope
+    class RngScope
+    {
+    public:
+        explicit RngScope(const CounterRng& rng) : _rng(rng), _previous(thread_rng_binding())
+        {
+            thread_rng_binding() = &_rng;
+        }
+        ~RngScope() { thread_rng_binding() = _previous; }
+
+        RngScope(const RngScope&) = delete;
+        RngScope & operator=(const RngScope &) = delete;
+
+    private:
+        CounterRng  _rng;
+        CounterRng* _previous;
+    };
+};
+
+#endif
@@ -0,0 +1,139 @@
+#pragma once
+//=================================================================================================
+//                    Copyright (C) 2017 Alain Lanthier - All Rights Reserved                      
+//=================================================================================================
+//
+// TaskPool : fixed set of worker threads running batches of indexed tasks
+//
+// run(n, fn) calls fn(worker, k) for k in [0, n) and returns when all are done. Several threads may call
+// run() at the same time: their batches share the workers (tasks are taken from the batches in turn).
+// A worker runs one task at a time, so per worker state (Ex: a game and its players) needs no lock.
+//
+// thread_concurrency() : threads a parallel section started by the calling thread may use
+// ConcurrencyScope     : caps thread_concurrency() of the calling thread for the scope (Ex: 2 concurrent tasks each starting threads)
+//
+#ifndef _AL_CHESS_CORE_TASK_POOL_HPP
+#define _AL_CHESS_CORE_TASK_POOL_HPP
+
+namespace chess
+{
+    // TaskPool
+    class TaskPool
+    {
+        struct Batch
+        {
+            const std::function<void(size_t, size_t)>*  _fn;
+            size_t                                      _n;
+            size_t                                      _next = 0;      // next task (under pool mutex)
+            size_t                                      _done = 0;      // tasks done (under batch mutex)
+            std::mutex                                  _mutex;
+            std::condition_variable                     _cv;
+        };
+
+    public:
+        explicit TaskPool(size_t nworker = std::thread::hardware_concurrency())
+        {
+            nworker = std::max<size_t>(1, nworker);
+            for (size_t w = 0; w < nworker; w++)
+                _workers.push_back(std::thread([this, w]() { work(w); }));
+        }
+
+        ~TaskPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stop = true;
+            }
+            _cv.notify_all();
+            for (auto& t : _workers) t.join();
+        }
+
+        TaskPool(const TaskPool&) = delete;
+        TaskPool & operator=(const TaskPool &) = delete;
+
+        size_t size() const { return _workers.size(); }
+
+        // run() - fn(worker, k) for k in [0, n), blocks until all done
+        void run(size_t n, const std::function<void(size_t, size_t)>& fn)
+        {
+            if (n == 0) return;
+
+            Batch b;
+            b._fn = &fn;
+            b._n = n;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _batches.push_back(&b);
+            }
+            _cv.notify_all();
+
+            std::unique_lock<std::mutex> lock(b._mutex);
+            b._cv.wait(lock, [&b]() { return b._done == b._n; });
+        }
+
+    private:
+        std::vector<std::thread>    _workers;
+        std::deque<Batch*>          _batches;
+        std::mutex                  _mutex;
+        std::condition_variable     _cv;
+        bool                        _stop = false;
+
+        void work(size_t w)
+        {
+            while (true)
+            {
+                Batch* b;
+                size_t k;
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _cv.wait(lock, [this]() { return _stop || !_batches.empty(); });
+                    if (_batches.empty()) return;
+
+                    // take a task of the front batch, then give the turn to the next batch
+                    b = _batches.front();
+                    _batches.pop_front();
+                    k = b->_next++;
+                    if (b->_next < b->_n) _batches.push_back(b);
+                }
+
+                (*b->_fn)(w, k);
+
+                std::lock_guard<std::mutex> lock(b->_mutex);
+                if (++b->_done == b->_n) b->_cv.notify_all();
+            }
+        }
+    };
+
+    inline unsigned& thread_concurrency_binding()
+    {
+        static thread_local unsigned n = 0;
+        return n;
+    }
+
+    // thread_concurrency() - share bound by the innermost ConcurrencyScope of the thread, else the hardware threads
+    inline unsigned thread_concurrency()
+    {
+        unsigned n = thread_concurrency_binding();
+        if (n == 0) n = std::thread::hardware_concurrency();
+        return std::max<unsigned>(1, n);
+    }
+
+    // ConcurrencyScope - a nested scope never raises the share of the enclosing one
+    class ConcurrencyScope
+    {
+    public:
+        explicit ConcurrencyScope(unsigned n) : _previous(thread_concurrency_binding())
+        {
+            thread_concurrency_binding() = std::max<unsigned>(1, std::min<unsigned>(n, thread_concurrency()));
+        }
+        ~ConcurrencyScope() { thread_concurrency_binding() = _previous; }
+
+        ConcurrencyScope(const ConcurrencyScope&) = delete;
+        ConcurrencyScope & operator=(const ConcurrencyScope &) = delete;
+
+    private:
+        unsigned _previous;
+    };
+};
+
+#endif
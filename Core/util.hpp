@@ -19,9 +19,26 @@ namespace chess
     std::string  toNULLSTR(const std::string& s) { return (s.size() == 0) ? "NullSTR" : s; }
     void         fromNULLSTR(std::string& s)     { if (s == "NullSTR") s = ""; }
 
-    std::random_device  rnd_dev;                    // uniformly - distributed integer random number generator
-    std::mt19937_64     rnd_generator(rnd_dev());   // Mersenne Twister 19937 pseudo-random number generator [0, pow(2,64))
-    std::uniform_real_distribution<double> uniform_double(0, 1);    // uniform random probability in range [0,1)     
+    // hash_mix64() - splitmix64 finalizer (bit mixing of a 64 bits key)
+    inline uint64_t hash_mix64(uint64_t x)
+    {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    // hash_string64() - FNV-1a (stable across runs and compilers, used for file names)
+    inline uint64_t hash_string64(const std::string& s)
+    {
+        uint64_t h = 0xCBF29CE484222325ULL;
+        for (unsigned char c : s)
+        {
+            h ^= c;
+            h *= 0x100000001B3ULL;
+        }
+        return h;
+    }
 
     void reverse_sq(uint16_t& sq, uint8_t _BoardSize)
     {
@@ -103,6 +103,10 @@ namespace chess
         virtual _Board*     first_position(PieceColor c) const { return nullptr; }
         virtual _Board*     next_position()  const { return nullptr; }
 
+        // Reentrant iteration (caller owns the cursor index and the board) - safe for concurrent walks of the domain
+        virtual uint64_t    position_count(PieceColor c) const { return 0; }
+        virtual bool        position_at(PieceColor c, uint64_t& index, uint64_t end, _Board& ret_board) const { return false; } // first position in [index, end)
+
         const std::vector<_Domain*>& children() const { return _children; }
         const std::string partition_key()       const { return _partition_key; }
         const std::string domainname_key()      const { return _domainname_key; }
@@ -390,9 +394,8 @@ namespace chess
             uint8_t bK = 0;
             while (wK == bK)
             {
-                // TODO: replace rand() by unbiases rnd...
-                wK = (std::rand() % _BoardSize*_BoardSize);
-                bK = (std::rand() % _BoardSize*_BoardSize);
+                wK = (uint8_t)thread_rng().below(_BoardSize*_BoardSize);
+                bK = (uint8_t)thread_rng().below(_BoardSize*_BoardSize);
             }
             _Board b; 
             b.set_pieceid_at(_Piece::get_id(PieceName::K, PieceColor::W), wK % _BoardSize, ((uint8_t)(wK / _BoardSize)));
@@ -500,9 +503,9 @@ namespace chess
             uint8_t bK = 0;
             while ((wK == bK)||(wK==wQ)||(bK==wQ))
             {
-                wQ = (std::rand() % (_BoardSize*_BoardSize));
-                wK = (std::rand() % (_BoardSize*_BoardSize));
-                bK = (std::rand() % (_BoardSize*_BoardSize));
+                wQ = (uint8_t)thread_rng().below(_BoardSize*_BoardSize);
+                wK = (uint8_t)thread_rng().below(_BoardSize*_BoardSize);
+                bK = (uint8_t)thread_rng().below(_BoardSize*_BoardSize);
             }
             _Board b;
             b.set_pieceid_at(_Piece::get_id(PieceName::Q, PieceColor::W), wQ % _BoardSize, ((uint8_t)(wQ / _BoardSize)));
@@ -141,10 +141,10 @@ namespace chess
                 }
             }
 
-            // Lookup score in TB
-            _tb_color = position.get_color();
-            if (_tb_color == PieceColor::none) return ExactScore::UNKNOWN;
-            TablebaseBase<PieceID, _BoardSize>* _TB = (_tb_color == PieceColor::W) ? _TB_W : _TB_B;
+            // Lookup score in TB (no domain state written: lookups may run concurrently)
+            PieceColor c = position.get_color();
+            if (c == PieceColor::none) return ExactScore::UNKNOWN;
+            TablebaseBase<PieceID, _BoardSize>* _TB = (c == PieceColor::W) ? _TB_W : _TB_B;
             if (_TB == nullptr) return ExactScore::UNKNOWN;
 
             std::vector<PieceID> v_id = position.get_piecesID();        // sorted
@@ -277,7 +277,7 @@ namespace chess
             uint16_t n = _ps.count_all_piece(PieceColor::W) + _ps.count_all_piece(PieceColor::B);
             std::vector<uint16_t> v_sq;
             v_sq.assign(n, 0);
-            for (size_t i = 0; i < n; i++) v_sq[i] = (uint16_t)(uniform_double(rnd_generator) * (_BoardSize*_BoardSize));
+            for (size_t i = 0; i < n; i++) v_sq[i] = (uint16_t)(thread_rng().uniform_double() * (_BoardSize*_BoardSize));
 
             bool ok = false;
             while (!ok)
@@ -294,7 +294,7 @@ namespace chess
                 if (!ok)
                 {
                     for (size_t i = 0; i < n; i++)
-                        v_sq[i] = (uint16_t)(uniform_double(rnd_generator) * (_BoardSize*_BoardSize));
+                        v_sq[i] = (uint16_t)(thread_rng().uniform_double() * (_BoardSize*_BoardSize));
                 }
             }
 
@@ -373,6 +373,33 @@ namespace chess
             _next_position_index++;
             return _work_board;
         }
+
+        uint64_t position_count(PieceColor c) const override
+        {
+            if (c == PieceColor::none) return 0;
+            TablebaseBase<PieceID, _BoardSize>* _TB = (c == PieceColor::W) ? _TB_W : _TB_B;
+            if (_TB == nullptr) return 0;
+            return _TB->is_full_type() ? _TB->size_tb() : _TB->size_full_tb();
+        }
+
+        bool position_at(PieceColor c, uint64_t& index, uint64_t end, _Board& ret_board) const override
+        {
+            if (c == PieceColor::none) return false;
+            TablebaseBase<PieceID, _BoardSize>* _TB = (c == PieceColor::W) ? _TB_W : _TB_B;
+            if (_TB == nullptr) return false;
+
+            std::vector<uint16_t> sq;
+            sq.assign(_TB->num_piece(), 0);
+            uint64_t m = std::min<uint64_t>(end, position_count(c));
+
+            for (; index < m; index++)
+            {
+                if (!_TB->valid_index(index, ret_board, sq)) continue;
+                if (_TB->score_v(sq) == ExactScore::UNKNOWN) continue;
+                return true;
+            }
+            return false;
+        }
     };
 
 };
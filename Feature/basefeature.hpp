@@ -82,6 +82,7 @@ namespace chess
         if (c == "cond_product_boolean")    return FeatureBasedAlgoName::cond_product_boolean;
         else if (c == "valu_weight_sum")    return FeatureBasedAlgoName::valu_weight_sum;
         else if (c == "rvm_trainer")        return FeatureBasedAlgoName::rvm_trainer;
+        else if (c == "svm_c_linear_dcd_trainer")   return FeatureBasedAlgoName::svm_c_linear_dcd_trainer;
         //...
         else return FeatureBasedAlgoName::none;
     }
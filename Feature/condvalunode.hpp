@@ -21,8 +21,8 @@
 
 namespace chess
 {
-    inline float  sigmoid(float x, float   a = 0.001f)  { return (1 / (1 + std::exp(-a * x))); }
-    inline double sigmoid(double x, double a = 0.001)   { return (1 / (1 + std::exp(-a * x))); }
+    inline float  sigmoid(float x, float   a = (float)SIGMOID_SCALE)  { return (1 / (1 + std::exp(-a * x))); }
+    inline double sigmoid(double x, double a = SIGMOID_SCALE)           { return (1 / (1 + std::exp(-a * x))); }
 
     // ConditionValuationNode - Brain nodes of a player
     template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
@@ -76,7 +76,7 @@ namespace chess
         std::list<_FeatureAlgoConfig>   _history_valu_algo_cfg;
 
     public:
-        ConditionValuationNode(ConditionValuationNode* parent, bool _is_positive_node, bool create_children) :
+        ConditionValuationNode(ConditionValuationNode* parent, bool _is_positive_node, bool create_children, bool new_persist_key = true) :
             _is_positive_node(_is_positive_node),
             _parent(parent),
             _positive_child(nullptr),
@@ -90,7 +90,8 @@ namespace chess
             _test_cond_algo(nullptr),
             _test_valu_algo(nullptr)
         {
-            _persist_key = PersistManager<PieceID, _BoardSize>::instance()->create_persist_key();
+            if (new_persist_key)
+                _persist_key = PersistManager<PieceID, _BoardSize>::instance()->create_persist_key();
             if (create_children)
             {
                 this->_positive_child = new ConditionValuationNode(this, true, false);
@@ -309,11 +310,57 @@ namespace chess
             }
         }
 
+        // clone_tree - deep copy of the branch (algos included, same persist keys) linked under parent. Ex: per thread player of GA tournament
+        _ConditionValuationNode* clone_tree(_ConditionValuationNode* parent) const
+        {
+            _ConditionValuationNode* node = new _ConditionValuationNode(parent, _is_positive_node, false, false);
+            node->_persist_key              = _persist_key;
+            node->_use_current_cond_algo    = _use_current_cond_algo;
+            node->_use_current_valu_algo    = _use_current_valu_algo;
+            if (_current_cond_algo != nullptr)  node->_current_cond_algo = (_FeatureCondAlgo*)_current_cond_algo->clone();
+            if (_current_valu_algo != nullptr)  node->_current_valu_algo = (_FeatureValuAlgo*)_current_valu_algo->clone();
+            if (_test_cond_algo != nullptr)     node->_test_cond_algo = (_FeatureCondAlgo*)_test_cond_algo->clone();
+            if (_test_valu_algo != nullptr)     node->_test_valu_algo = (_FeatureValuAlgo*)_test_valu_algo->clone();
+
+            node->_history_positive_child_cond_algo_cfg = _history_positive_child_cond_algo_cfg;
+            node->_history_negative_child_cond_algo_cfg = _history_negative_child_cond_algo_cfg;
+            node->_history_positive_child_valu_algo_cfg = _history_positive_child_valu_algo_cfg;
+            node->_history_negative_child_valu_algo_cfg = _history_negative_child_valu_algo_cfg;
+            node->_history_cond_algo_cfg = _history_cond_algo_cfg;
+            node->_history_valu_algo_cfg = _history_valu_algo_cfg;
+
+            // recursion - positive first, the negative child constructor links the mirrors
+            if (_positive_child != nullptr) _positive_child->clone_tree(node);
+            if (_negative_child != nullptr) _negative_child->clone_tree(node);
+            return node;
+        }
+
         _FeatureCondAlgo*   current_cond_algo() { return _current_cond_algo; }
         _FeatureValuAlgo*   current_valu_algo() { return _current_valu_algo; }
         _FeatureCondAlgo*   test_cond_algo()    { return _test_cond_algo; }
         _FeatureValuAlgo*   test_valu_algo()    { return _test_valu_algo; }
 
+        // algo used by get_condition_value()/get_valuations_value() (current or test)
+        const _FeatureCondAlgo* active_cond_algo() const
+        {
+            const _ConditionValuationNode* node = (!_is_positive_node && (_link_to_mirror != nullptr)) ? _link_to_mirror : this;
+            return _use_current_cond_algo ? node->_current_cond_algo : node->_test_cond_algo;
+        }
+        const _FeatureValuAlgo* active_valu_algo() const { return _use_current_valu_algo ? _current_valu_algo : _test_valu_algo; }
+
+        // get_weights/set_weights - weights of a valu_weight_sum current algo (empty/ignored otherwise), Ex: GA or optimizer parameters
+        std::vector<TYPE_PARAM> get_weights() const
+        {
+            if ((_current_valu_algo != nullptr) && (_current_valu_algo->cfg()._name == FeatureBasedAlgoName::valu_weight_sum))
+                return ((const _FeatureValuAlgo_weight_sum*)_current_valu_algo)->weights();
+            return std::vector<TYPE_PARAM>();
+        }
+        void set_weights(const std::vector<TYPE_PARAM>& w)
+        {
+            if ((_current_valu_algo != nullptr) && (_current_valu_algo->cfg()._name == FeatureBasedAlgoName::valu_weight_sum))
+                ((_FeatureValuAlgo_weight_sum*)_current_valu_algo)->set_weights(w);
+        }
+
         void update_child_cond_valu_algo(bool only_hist = false)
         {
             if (_positive_child != nullptr)
@@ -321,7 +368,7 @@ namespace chess
                 if (_positive_child->_test_cond_algo != nullptr)
                     _history_positive_child_cond_algo_cfg.push_back(_positive_child->_test_cond_algo->cfg());
                 if (_positive_child->_test_cond_algo != nullptr)
-                    _history_negative_child_cond_algo_cfg.push_back(_positive_child->_test_cond_algo->cfg()) // mirror
+                    _history_negative_child_cond_algo_cfg.push_back(_positive_child->_test_cond_algo->cfg()); // mirror
             }
             if (_negative_child != nullptr)
             {
@@ -392,7 +439,7 @@ namespace chess
         void set_test_cond_algo(_FeatureCondAlgo* algo)
         {
             if (algo == nullptr) return;
-            if (_test_cond_algo != nullptr)
+            if ((_test_cond_algo != nullptr) && (_test_cond_algo != algo))    // set again: same algo kept
             {
                 delete _test_cond_algo;
                 _test_cond_algo = nullptr;
@@ -434,7 +481,7 @@ namespace chess
         {
             if (algo == nullptr) return;
 
-            if (_test_valu_algo != nullptr)
+            if ((_test_valu_algo != nullptr) && (_test_valu_algo != algo))    // set again: same algo kept
             {
                 delete _test_valu_algo;
                 _test_valu_algo = nullptr;
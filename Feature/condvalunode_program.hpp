@@ -0,0 +1,405 @@
+#pragma once
+//=================================================================================================
+//                    Copyright (C) 2017 Alain Lanthier - All Rights Reserved                      
+//=================================================================================================
+//
+// CondValuNodeProgram : ConditionValuationNode tree compiled into a flat instruction array
+//
+// The tree shape only changes when CondValuNodeChanger (or the GA) modifies the player, so the
+// tree is compiled once and the program is run for every evaluated position instead of walking
+// node pointers and virtual algo calls. Features are referenced by index in a program feature
+// table (shared features are listed once), cond_product_boolean and valu_weight_sum are inlined
+// as instructions, any other algo (rvm, ...) is called through its virtual interface.
+//
+// Program layout (depth first, positive branch first):
+//      internal node : <condition of positive child> jump_if_false(negative) <positive subtree> <negative subtree>
+//      terminal node : weight_sum | call_valu | fail   (all return)
+//
+#ifndef _AL_CHESS_FEATURE_CONDVALNODE_PROGRAM_HPP
+#define _AL_CHESS_FEATURE_CONDVALNODE_PROGRAM_HPP
+
+namespace chess
+{
+    enum class NodeOpCode : uint8_t
+    {
+        cond_true,      // acc = true
+        cond_first,     // acc = cond[a]
+        cond_and,       // acc = acc && cond[a]
+        cond_or,        // acc = acc || cond[a]
+        call_cond,      // acc = cond_algo[a]->get_condition_value()
+        jump_if_false,  // if (!acc) pc = a
+        weight_sum,     // return sigmoid(sum(valu[term.feature] * term.weight)) for terms [a, a+b)
+        call_valu,      // return valu_algo[a]->get_valuations_value()
+        fail            // malformed node
+    };
+
+    struct NodeInstr
+    {
+        NodeOpCode  _op;
+        uint32_t    _a;
+        uint32_t    _b;
+    };
+
+    // CondValuNodeProgram
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    class CondValuNodeProgram
+    {
+        using _Board    = Board<PieceID, _BoardSize>;
+        using _Move     = Move<PieceID>;
+        using _ConditionFeature = ConditionFeature<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _ValuationFeature = ValuationFeature<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _ConditionValuationNode = ConditionValuationNode<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _FeatureCondAlgo  = FeatureCondAlgo<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _FeatureValuAlgo  = FeatureValuAlgo<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _FeatureValuAlgo_weight_sum = FeatureValuAlgo_weight_sum<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _FeatureCondAlgo_cond_product_boolean = FeatureCondAlgo_cond_product_boolean<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _FeatureContext   = FeatureContext<PieceID, _BoardSize>;
+
+        struct WeightTerm
+        {
+            uint32_t    _feature;
+            TYPE_PARAM  _weight;
+        };
+
+    public:
+        CondValuNodeProgram() {}
+        ~CondValuNodeProgram() {}
+
+        bool compile(const _ConditionValuationNode* root);
+        void clear();
+        bool is_compiled() const { return !_code.empty(); }
+
+        // eval() - run on a position, features computed on demand (only those on the taken path)
+        bool eval(const _Board& position, const std::vector<_Move>& m, TYPE_PARAM& ret_eval) const;
+
+        // run() - run against a precomputed feature vector (cond_values[i] of cond_features()[i], valu_values[i] of valu_features()[i])
+        // call_cond/call_valu instructions still need the position
+        bool run(const _Board& position, const std::vector<_Move>& m,
+                 const std::vector<char>& cond_values, const std::vector<TYPE_PARAM>& valu_values, TYPE_PARAM& ret_eval) const;
+
+        // compute_features() - full feature vector of a position for run()
+        void compute_features(const _Board& position, const std::vector<_Move>& m, std::vector<char>& cond_values, std::vector<TYPE_PARAM>& valu_values) const;
+
+        const std::vector<_ConditionFeature*>& cond_features() const { return _cond_features; }
+        const std::vector<_ValuationFeature*>& valu_features() const { return _valu_features; }
+        const std::vector<NodeInstr>&          code()          const { return _code; }
+
+        std::string to_str() const;
+
+    protected:
+        std::vector<NodeInstr>                  _code;
+        std::vector<WeightTerm>                 _terms;
+        std::vector<_ConditionFeature*>         _cond_features;     // not owner
+        std::vector<_ValuationFeature*>         _valu_features;     // not owner
+        std::vector<const _FeatureCondAlgo*>    _cond_algos;        // not owner
+        std::vector<const _FeatureValuAlgo*>    _valu_algos;        // not owner
+        std::map<const _ConditionFeature*, uint32_t> _cond_index;
+        std::map<const _ValuationFeature*, uint32_t> _valu_index;
+
+        bool        compile_node(const _ConditionValuationNode* node);
+        void        compile_condition(const _ConditionValuationNode* node);
+        void        compile_valuation(const _ConditionValuationNode* node);
+        uint32_t    emit(NodeOpCode op, uint32_t a = 0, uint32_t b = 0);
+        uint32_t    cond_feature_index(_ConditionFeature* f);
+        uint32_t    valu_feature_index(_ValuationFeature* f);
+
+        template <typename FeatureSource>
+        bool exec(const _Board& position, const std::vector<_Move>& m, FeatureSource& src, TYPE_PARAM& ret_eval) const;
+
+        // Feature sources of exec()
+        struct PrecomputedSource
+        {
+            const std::vector<char>&        _cond;
+            const std::vector<TYPE_PARAM>&  _valu;
+            PrecomputedSource(const std::vector<char>& c, const std::vector<TYPE_PARAM>& v) : _cond(c), _valu(v) {}
+            bool        cond(uint32_t i) { return _cond[i] != 0; }
+            TYPE_PARAM  valu(uint32_t i) { return _valu[i]; }
+        };
+
+        struct LazySource
+        {
+            const CondValuNodeProgram&      _prog;
+            const _Board&                   _position;
+            const std::vector<_Move>&       _m;
+            std::unique_ptr<_FeatureContext> _ctx;      // built at the first valuation feature
+            LazySource(const CondValuNodeProgram& p, const _Board& b, const std::vector<_Move>& m) : _prog(p), _position(b), _m(m) {}
+            bool cond(uint32_t i) { return _prog._cond_features[i]->check(_position, _m); }
+            TYPE_PARAM valu(uint32_t i)
+            {
+                if (!_ctx) _ctx.reset(new _FeatureContext(_position, _m));
+                return _prog._valu_features[i]->compute(*_ctx);
+            }
+        };
+    };
+
+    // clear()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    void CondValuNodeProgram<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::clear()
+    {
+        _code.clear();
+        _terms.clear();
+        _cond_features.clear();
+        _valu_features.clear();
+        _cond_algos.clear();
+        _valu_algos.clear();
+        _cond_index.clear();
+        _valu_index.clear();
+    }
+
+    // compile()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    bool CondValuNodeProgram<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::compile(const _ConditionValuationNode* root)
+    {
+        clear();
+        if (root == nullptr) return false;
+        if (!compile_node(root))
+        {
+            clear();
+            return false;
+        }
+        return true;
+    }
+
+    // compile_node()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    bool CondValuNodeProgram<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::compile_node(const _ConditionValuationNode* node)
+    {
+        const _ConditionValuationNode* pos = node->positive_child();
+        const _ConditionValuationNode* neg = node->negative_child();
+
+        if ((pos != nullptr) && (neg != nullptr))
+        {
+            // same decision as get_terminal_node(): the positive child condition selects the branch
+            compile_condition(pos);
+            uint32_t jmp = emit(NodeOpCode::jump_if_false);
+            if (!compile_node(pos)) return false;
+            _code[jmp]._a = (uint32_t)_code.size();
+            return compile_node(neg);
+        }
+        else if ((pos == nullptr) && (neg == nullptr))
+        {
+            compile_valuation(node);
+            return true;
+        }
+
+        // error
+        return false;
+    }
+
+    // compile_condition()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    void CondValuNodeProgram<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::compile_condition(const _ConditionValuationNode* node)
+    {
+        const _FeatureCondAlgo* algo = node->active_cond_algo();
+        if (algo == nullptr)
+        {
+            emit(NodeOpCode::fail);
+            return;
+        }
+
+        if (algo->cfg()._name == FeatureBasedAlgoName::cond_product_boolean)
+        {
+            const _FeatureCondAlgo_cond_product_boolean* a = (const _FeatureCondAlgo_cond_product_boolean*)algo;
+            const std::vector<_ConditionFeature*>& c = a->conditions();
+            const std::vector<bool>& and_or = a->conditions_and_or();
+            if (c.size() == 0)
+            {
+                emit(NodeOpCode::cond_true);
+                return;
+            }
+            for (size_t i = 0; i < c.size(); i++)
+            {
+                if (i == 0)             emit(NodeOpCode::cond_first, cond_feature_index(c[0]));    // and_or[0] ignored
+                else if (and_or[i])     emit(NodeOpCode::cond_and, cond_feature_index(c[i]));
+                else                    emit(NodeOpCode::cond_or, cond_feature_index(c[i]));
+            }
+        }
+        else
+        {
+            _cond_algos.push_back(algo);
+            emit(NodeOpCode::call_cond, (uint32_t)(_cond_algos.size() - 1), node->isRoot() ? 1 : 0);
+        }
+    }
+
+    // compile_valuation()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    void CondValuNodeProgram<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::compile_valuation(const _ConditionValuationNode* node)
+    {
+        const _FeatureValuAlgo* algo = node->active_valu_algo();
+        if (algo == nullptr)
+        {
+            emit(NodeOpCode::fail);
+            return;
+        }
+
+        if (algo->cfg()._name == FeatureBasedAlgoName::valu_weight_sum)
+        {
+            const _FeatureValuAlgo_weight_sum* a = (const _FeatureValuAlgo_weight_sum*)algo;
+            const std::vector<_ValuationFeature*>& v = a->valuations();
+            const std::vector<TYPE_PARAM>& w = a->weights();
+            assert(w.size() >= v.size());
+
+            uint32_t start = (uint32_t)_terms.size();
+            for (size_t i = 0; i < v.size(); i++)
+            {
+                WeightTerm t;
+                t._feature = valu_feature_index(v[i]);
+                t._weight = w[i];
+                _terms.push_back(t);
+            }
+            emit(NodeOpCode::weight_sum, start, (uint32_t)v.size());
+        }
+        else
+        {
+            _valu_algos.push_back(algo);
+            emit(NodeOpCode::call_valu, (uint32_t)(_valu_algos.size() - 1));
+        }
+    }
+
+    // emit()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    uint32_t CondValuNodeProgram<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::emit(NodeOpCode op, uint32_t a, uint32_t b)
+    {
+        NodeInstr instr;
+        instr._op = op;
+        instr._a = a;
+        instr._b = b;
+        _code.push_back(instr);
+        return (uint32_t)(_code.size() - 1);
+    }
+
+    // cond_feature_index()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    uint32_t CondValuNodeProgram<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::cond_feature_index(_ConditionFeature* f)
+    {
+        auto it = _cond_index.find(f);
+        if (it != _cond_index.end()) return it->second;
+        uint32_t idx = (uint32_t)_cond_features.size();
+        _cond_features.push_back(f);
+        _cond_index[f] = idx;
+        return idx;
+    }
+
+    // valu_feature_index()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    uint32_t CondValuNodeProgram<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::valu_feature_index(_ValuationFeature* f)
+    {
+        auto it = _valu_index.find(f);
+        if (it != _valu_index.end()) return it->second;
+        uint32_t idx = (uint32_t)_valu_features.size();
+        _valu_features.push_back(f);
+        _valu_index[f] = idx;
+        return idx;
+    }
+
+    // exec() - the interpreter
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    template <typename FeatureSource>
+    bool CondValuNodeProgram<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::
+    exec(const _Board& position, const std::vector<_Move>& m, FeatureSource& src, TYPE_PARAM& ret_eval) const
+    {
+        const NodeInstr* code = _code.data();
+        const size_t n = _code.size();
+        size_t pc = 0;
+        bool acc = true;
+
+        while (pc < n)
+        {
+            const NodeInstr& instr = code[pc++];
+            switch (instr._op)
+            {
+            case NodeOpCode::cond_true:     acc = true; break;
+            case NodeOpCode::cond_first:    acc = src.cond(instr._a); break;
+            case NodeOpCode::cond_and:      acc = acc && src.cond(instr._a); break;
+            case NodeOpCode::cond_or:       acc = acc || src.cond(instr._a); break;
+            case NodeOpCode::call_cond:     acc = _cond_algos[instr._a]->get_condition_value(instr._b != 0, true, position, m); break;
+            case NodeOpCode::jump_if_false: if (!acc) pc = instr._a; break;
+
+            case NodeOpCode::weight_sum:
+            {
+                TYPE_PARAM c = 0;
+                const WeightTerm* t = _terms.data() + instr._a;
+                for (uint32_t i = 0; i < instr._b; i++)
+                    c += src.valu(t[i]._feature) * t[i]._weight;
+                ret_eval = sigmoid(c);
+                return true;
+            }
+
+            case NodeOpCode::call_valu:
+            {
+                std::stringstream ss;
+                ret_eval = _valu_algos[instr._a]->get_valuations_value(position, m, 0, ss);
+                return true;
+            }
+
+            default:
+                return false;
+            }
+        }
+        return false;
+    }
+
+    // eval()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    bool CondValuNodeProgram<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::
+    eval(const _Board& position, const std::vector<_Move>& m, TYPE_PARAM& ret_eval) const
+    {
+        LazySource src(*this, position, m);
+        return exec(position, m, src, ret_eval);
+    }
+
+    // run()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    bool CondValuNodeProgram<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::
+    run(const _Board& position, const std::vector<_Move>& m,
+        const std::vector<char>& cond_values, const std::vector<TYPE_PARAM>& valu_values, TYPE_PARAM& ret_eval) const
+    {
+        assert(cond_values.size() >= _cond_features.size());
+        assert(valu_values.size() >= _valu_features.size());
+        PrecomputedSource src(cond_values, valu_values);
+        return exec(position, m, src, ret_eval);
+    }
+
+    // compute_features()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    void CondValuNodeProgram<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::
+    compute_features(const _Board& position, const std::vector<_Move>& m, std::vector<char>& cond_values, std::vector<TYPE_PARAM>& valu_values) const
+    {
+        cond_values.resize(_cond_features.size());
+        for (size_t i = 0; i < _cond_features.size(); i++)
+            cond_values[i] = _cond_features[i]->check(position, m) ? 1 : 0;
+        _ValuationFeature::compute_all(position, m, _valu_features, valu_values);
+    }
+
+    // to_str()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    std::string CondValuNodeProgram<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::to_str() const
+    {
+        std::stringstream ss;
+        for (size_t pc = 0; pc < _code.size(); pc++)
+        {
+            const NodeInstr& instr = _code[pc];
+            ss << pc << ": ";
+            switch (instr._op)
+            {
+            case NodeOpCode::cond_true:     ss << "cond_true"; break;
+            case NodeOpCode::cond_first:    ss << "cond_first " << _cond_features[instr._a]->classtype(); break;
+            case NodeOpCode::cond_and:      ss << "cond_and " << _cond_features[instr._a]->classtype(); break;
+            case NodeOpCode::cond_or:       ss << "cond_or " << _cond_features[instr._a]->classtype(); break;
+            case NodeOpCode::call_cond:     ss << "call_cond " << FeatureBasedAlgoName_to_string(_cond_algos[instr._a]->cfg()._name); break;
+            case NodeOpCode::jump_if_false: ss << "jump_if_false " << instr._a; break;
+            case NodeOpCode::weight_sum:
+                ss << "weight_sum";
+                for (uint32_t i = 0; i < instr._b; i++)
+                    ss << " " << _valu_features[_terms[instr._a + i]._feature]->classtype() << "*" << _terms[instr._a + i]._weight;
+                break;
+            case NodeOpCode::call_valu:     ss << "call_valu " << FeatureBasedAlgoName_to_string(_valu_algos[instr._a]->cfg()._name); break;
+            default:                        ss << "fail"; break;
+            }
+            ss << std::endl;
+        }
+        return ss.str();
+    }
+};
+
+#endif
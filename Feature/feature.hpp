@@ -69,6 +69,7 @@ namespace chess
         using _Board = Board<PieceID, _BoardSize>;
         using _Move = Move<PieceID>;
         using _FeatureManager = FeatureManager<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _FeatureContext = FeatureContext<PieceID, _BoardSize>;
 
     public:
         ValuationFeature() : BaseFeature(FeatureType::valuation), _PARAM_NBIT(PARAM_NBIT){ }
@@ -77,6 +78,18 @@ namespace chess
         virtual TYPE_PARAM compute(const _Board& position, const std::vector<_Move>& m) const = 0; // compute value on a board position
         ValuFeatureName name() const { return _name; }
 
+        // compute value from a shared per position context (no own board scan/move generation)
+        virtual TYPE_PARAM compute(const _FeatureContext& ctx) const { return compute(ctx.position(), ctx.moves()); }
+
+        // compute_all() - dense feature vector of all features in one pass over a single context
+        static void compute_all(const _Board& position, const std::vector<_Move>& m, const std::vector<ValuationFeature*>& features, std::vector<TYPE_PARAM>& ret_values)
+        {
+            _FeatureContext ctx(position, m);
+            ret_values.resize(features.size());
+            for (size_t i = 0; i < features.size(); i++)
+                ret_values[i] = features[i]->compute(ctx);
+        }
+
     protected:
         size_t  _PARAM_NBIT;
         ValuFeatureName _name;
@@ -89,6 +102,7 @@ namespace chess
         using _Board = Board<PieceID, _BoardSize>;
         using _Move = Move<PieceID>;
         using _Piece = Piece<PieceID, _BoardSize>;
+        using _FeatureContext = FeatureContext<PieceID, _BoardSize>;
 
     public:
         ValuationFeature_numberMoveForPiece(const PieceName p, const PieceColor c) : _ValuationFeature() , _p(p), _c(c)
@@ -118,6 +132,11 @@ namespace chess
             else                            return (TYPE_PARAM)position.cnt_move_oppo(_p, _c, m);
         }
 
+        virtual TYPE_PARAM compute(const _FeatureContext& ctx) const override
+        {
+            return (TYPE_PARAM)ctx.cnt_move(_Piece::get_id(_p, _c));
+        }
+
         PieceName  piecename()  { return _p; }
         PieceColor piececolor() { return _c; }
 
@@ -142,6 +161,7 @@ namespace chess
         using _Board = Board<PieceID, _BoardSize>;
         using _Move = Move<PieceID>;
         using _Piece = Piece<PieceID, _BoardSize>;
+        using _FeatureContext = FeatureContext<PieceID, _BoardSize>;
 
     public:
         ValuationFeature_countCaptureKing(const PieceColor color): _c(color)
@@ -163,6 +183,11 @@ namespace chess
             else                            return (TYPE_PARAM)position.count_capture_opposite_king(m);
         }
 
+        virtual TYPE_PARAM compute(const _FeatureContext& ctx) const override
+        {
+            return (TYPE_PARAM)ctx.king_capture(_c);
+        }
+
     private:
         PieceColor  _c;
     };
@@ -175,6 +200,7 @@ namespace chess
         using _Board    = Board<PieceID, _BoardSize>;
         using _Move     = Move<PieceID>;
         using _Piece    = Piece<PieceID, _BoardSize>;
+        using _FeatureContext = FeatureContext<PieceID, _BoardSize>;
 
     public:
         ValuationFeature_onEdge(const PieceName p, const PieceColor c) : _ValuationFeature(), _p(p), _c(c)
@@ -194,6 +220,19 @@ namespace chess
             return (TYPE_PARAM)position.on_edge(_p, _c);
         }
 
+        virtual TYPE_PARAM compute(const _FeatureContext& ctx) const override
+        {
+            uint8_t cnt = 0;
+            uint8_t x, y;
+            for (auto& sq : ctx.squares(_Piece::get_id(_p, _c)))
+            {
+                x = _FeatureContext::x_of(sq);
+                y = _FeatureContext::y_of(sq);
+                if ((x == 0) || (x == _BoardSize - 1) || (y == 0) || (y == _BoardSize - 1)) cnt++;
+            }
+            return (TYPE_PARAM)cnt;
+        }
+
         PieceName  piecename()  { return _p; }
         PieceColor piececolor() { return _c; }
 
@@ -209,6 +248,7 @@ namespace chess
         using _Board = Board<PieceID, _BoardSize>;
         using _Move = Move<PieceID>;
         using _Piece = Piece<PieceID, _BoardSize>;
+        using _FeatureContext = FeatureContext<PieceID, _BoardSize>;
 
     public:
         ValuationFeature_distKK() : _ValuationFeature()
@@ -226,6 +266,14 @@ namespace chess
         {
             return (TYPE_PARAM)position.dist(PieceName::K, PieceColor::W, PieceName::K, PieceColor::B);
         }
+
+        virtual TYPE_PARAM compute(const _FeatureContext& ctx) const override
+        {
+            if (!ctx.has_king(PieceColor::W) || !ctx.has_king(PieceColor::B)) return 0;
+            uint16_t w = ctx.king_sq(PieceColor::W);
+            uint16_t b = ctx.king_sq(PieceColor::B);
+            return (TYPE_PARAM)std::max( std::abs(_FeatureContext::x_of(w) - _FeatureContext::x_of(b)), std::abs(_FeatureContext::y_of(w) - _FeatureContext::y_of(b)) );
+        }
     };
 
 };
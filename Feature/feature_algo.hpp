@@ -35,6 +35,9 @@ namespace chess
         }
         virtual ~FeatureAlgo() {}
 
+        // clone() - deep copy (Ex: per thread copy of a player node tree)
+        virtual FeatureAlgo* clone() const = 0;
+
         _FeatureAlgoConfig& cfg()               { return _cfg; }
         const _FeatureAlgoConfig& cfg() const   { return _cfg; }
         FeatureAlgoStatus& status()             { return _cfg._status; } 
@@ -200,6 +203,7 @@ namespace chess
     {
         if      (cfg._name == FeatureBasedAlgoName::cond_product_boolean)   return (FeatureAlgo<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>* )new FeatureCondAlgo_cond_product_boolean<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>(cfg);
         else if (cfg._name == FeatureBasedAlgoName::valu_weight_sum)        return (FeatureAlgo<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>* )new FeatureValuAlgo_weight_sum<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>(cfg);
+        else if (cfg._name == FeatureBasedAlgoName::svm_c_linear_dcd_trainer)   return (FeatureAlgo<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>* )new FeatureValuAlgo_svm_c_linear_dcd_trainer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>(cfg);
         //...
         return nullptr;
     }
@@ -35,6 +35,11 @@ namespace chess
         }
         ~FeatureCondAlgo_cond_product_boolean() {}
 
+        _FeatureAlgo* clone() const override { return new FeatureCondAlgo_cond_product_boolean(*this); }
+
+        const std::vector<_ConditionFeature*>&  conditions()        const { return _conditions; }
+        const std::vector<bool>&                conditions_and_or() const { return _conditions_and_or; }
+
         virtual bool get_condition_value(bool is_root, bool is_positive_node, const _Board& position, const std::vector<_Move>& m) const 
         {
             if (is_root) return true;
@@ -171,7 +176,7 @@ namespace chess
             for (size_t i = 0; i < _conditions.size(); i++)
             {
                 if (i == 0) _conditions_and_or[0] = true;
-                else if (uniform_double(rnd_generator) >= 0.50)
+                else if (thread_rng().uniform_double() >= 0.50)
                 {
                     _conditions_and_or[i] = false;  // OR
                 }
@@ -13,6 +13,28 @@
 
 namespace chess
 {
+    // RffErrorReport - random Fourier feature approximation vs exact RBF probabilistic function
+    struct RffErrorReport
+    {
+        size_t  _dim = 0;               // random features
+        size_t  _num_basis = 0;         // relevance vectors of the exact function
+        double  _train_rms = 0;         // probability error
+        double  _train_max = 0;
+        double  _train_class_diff = 0;  // fraction of samples with another WIN/DRAW/LOSS class
+        double  _test_rms = 0;
+        double  _test_max = 0;
+        double  _test_class_diff = 0;
+
+        std::string to_str() const
+        {
+            std::stringstream ss;
+            ss << "rff dim: " << _dim << " (rv: " << _num_basis << ")";
+            ss << " train rms/max/class: " << _train_rms << "/" << _train_max << "/" << _train_class_diff;
+            ss << " test rms/max/class: " << _test_rms << "/" << _test_max << "/" << _test_class_diff;
+            return ss.str();
+        }
+    };
+
     // FeatureValuAlgo_rvm_trainer
     template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
     class FeatureValuAlgo_rvm_trainer : public FeatureValuAlgo<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>
@@ -27,6 +49,7 @@ namespace chess
         using _FeatureValuAlgo      = FeatureValuAlgo<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
         using _FeatureAlgoConfig    = FeatureAlgoConfig<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
         using _DomainPlayer         = DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _FeatureDatasetBuilder = FeatureDatasetBuilder<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
     
     private:
         typedef dlib::matrix<double, 0, 1>                          sample_type;
@@ -58,6 +81,38 @@ namespace chess
         // work area
         STRUCT_DATASET                          _training_dataset;
         STRUCT_DATASET                          _testing_dataset;
+        double                                  _gamma = 0.08;      // RBF gamma selected by cross validation
+
+        // random Fourier feature approximation of _learned_pfunct in raw feature space (training normalizer folded in):
+        //      f(x) = _rff_bias + sum_k _rff_beta[k] * cos(_rff_omega[k].x + _rff_phase[k]),  prob = 1/(1+exp(alpha*f + beta))
+        std::vector<double>                     _rff_omega;         // _rff_dim rows of nfeature, row major
+        std::vector<double>                     _rff_phase;
+        std::vector<double>                     _rff_beta;
+        double                                  _rff_bias = 0;
+        bool                                    _use_rff = false;   // approximation accurate enough (_rff_max_error) and faster
+        RffErrorReport                          _rff_report;
+
+        // gamma search options
+        static size_t                           _cv_folds;          // k-fold cross validation of each gamma candidate
+        static size_t                           _cv_coarse_size;    // coarse grid cross validated on the first n training samples only (0 = all)
+        static size_t                           _cv_refine;         // fine rounds around the best coarse gamma (2 candidates per round)
+        static bool                             _cv_refine_full;    // fine rounds cross validated on the full training set (opt-in: k trainings per candidate)
+        static bool                             _parallel_cv;       // (gamma, fold) trainings run concurrently
+
+        // random Fourier features options
+        static size_t                           _rff_dim;           // number of random features (0 = no approximation)
+        static double                           _rff_max_error;     // max RMS probability error on the testing set to use the approximation
+        static double                           _rff_ridge;         // least squares regularization
+        static uint64_t                         _rff_seed;
+        static constexpr const char*            RFF_TAG = "rff1";  // saved after _learned_pfunct, versions the RFF section
+
+        struct FoldResult
+        {
+            size_t _pos = 0;
+            size_t _pos_ok = 0;
+            size_t _neg = 0;
+            size_t _neg_ok = 0;
+        };
 
     public:
         FeatureValuAlgo_rvm_trainer(const _FeatureAlgoConfig& cfg) : _FeatureValuAlgo(cfg)
@@ -65,14 +120,33 @@ namespace chess
         }
         ~FeatureValuAlgo_rvm_trainer() {}
 
+        _FeatureAlgo* clone() const override { return new FeatureValuAlgo_rvm_trainer(*this); }
+
+        double          gamma() const                   { return _gamma; }
+        static void     set_cv_folds(size_t n)          { _cv_folds = std::max<size_t>(2, n); }
+        static void     set_cv_coarse_size(size_t n)    { _cv_coarse_size = n; }
+        static void     set_cv_refine(size_t n)         { _cv_refine = n; }
+        static void     set_cv_refine_full(bool v)      { _cv_refine_full = v; }
+        static void     set_parallel_cv(bool v)         { _parallel_cv = v; }
+        static void     set_rff_dim(size_t n)           { _rff_dim = n; }
+        static void     set_rff_max_error(double v)     { _rff_max_error = v; }
+        static void     set_rff_ridge(double v)         { _rff_ridge = v; }
+        static void     set_rff_seed(uint64_t v)        { _rff_seed = v; }
+
+        const RffErrorReport& rff_report() const        { return _rff_report; }
+        bool                  use_rff() const           { return _use_rff; }
+
         TYPE_PARAM get_valuations_value(const _Board& position, const std::vector<_Move>& m, char verbose, std::stringstream& verbose_stream) const override
         { 
             sample_type samp;
             samp.set_size(_valuations.size());
+            std::vector<TYPE_PARAM> values;
+            _ValuationFeature::compute_all(position, m, _valuations, values);
             for (size_t i = 0; i < _valuations.size(); i++)
             {
-                samp(i) = _valuations[i]->compute(position, m);
+                samp(i) = values[i];
             }
+            if (_use_rff) return (TYPE_PARAM)rff_prob(samp);
             //return (TYPE_PARAM)learned_function(samp);  // sigmoid(c);
             return (TYPE_PARAM)_learned_pfunct(samp);
         }
@@ -89,7 +163,22 @@ namespace chess
             }
             if (!load_detail(is))
             {
-                dlib::deserialize(f) >> _learned_pfunct;
+                dlib::proxy_deserialize in = dlib::deserialize(f);
+                in >> _learned_pfunct;
+
+                // RFF section tagged, files saved before the approximation end after _learned_pfunct (exact function used)
+                std::string tag;
+                try { in >> tag; }
+                catch (dlib::serialization_error&) { tag.clear(); }
+                if (tag == RFF_TAG)
+                {
+                    in >> _use_rff >> _rff_omega >> _rff_phase >> _rff_beta >> _rff_bias;
+                }
+                else
+                {
+                    _use_rff = false;
+                    _rff_omega.clear(); _rff_phase.clear(); _rff_beta.clear(); _rff_bias = 0;
+                }
                 is.close();
                 return true;
             }
@@ -131,7 +220,7 @@ namespace chess
             os.open(f.c_str(), std::fstream::out | std::fstream::trunc);
             if (save_detail(os))
             {
-                dlib::serialize(f) << _learned_pfunct;
+                dlib::serialize(f) << _learned_pfunct << std::string(RFF_TAG) << _use_rff << _rff_omega << _rff_phase << _rff_beta << _rff_bias;
 
                 os.close();
                 return true;
@@ -173,90 +262,41 @@ namespace chess
                 }
             }
 
-            std::vector<_ConditionValuationNode*> v_nodes = node->get_path(); // in reverse order 
-            _Board* b = player.domain()->first_position( player.color_player() );
-            if (b == nullptr)
+            // sharded parallel walk of the domain, same samples as a walk in index order
+            // the serial walk alternated samples training/testing and stopped when one set was full (2n-1 samples)
+            FeatureDataset ds;
+            size_t max_samples = (max_size_dataset > 0) ? 2 * max_size_dataset - 1 : 0;
+            if (!_FeatureDatasetBuilder::build(player, node, _valuations, max_samples, ds))
             {
                 //...
                 return false;
             }
 
-            bool pos_in_domain_and_node;
-            ExactScore sc;
-            std::vector<_Move> m;
-            size_t ret_mv_idx;
-
-            while ((_training_dataset._samples.size() < max_size_dataset) && (_testing_dataset._samples.size() < max_size_dataset))
+            // WIN_OTHER is keeping all data, WIN_LOSS is skipping DRAW score, ...
+            if (_score_binary_class == ScoreBinaryClassifier::WIN_OTHER)
             {
-                pos_in_domain_and_node = true;
-                if (player.domain()->isInDomain(*b))
-                {
-                    // does position match node path Fcond[] implicit sub_domain
-                    bool cond = true;
-                    m = b->generate_moves();
-                    for (size_t i = v_nodes.size() - 1; i >= 0; i--)
-                    {
-                        if (i != v_nodes.size() - 1)
-                        {
-                            cond = v_nodes[i]->get_condition_value(*b, m);
-                            if ((cond && v_nodes[i]->is_positive_node()) || (!cond && !v_nodes[i]->is_positive_node()))
-                            {
-                                // ok
-                            }
-                            else
-                            {
-                                pos_in_domain_and_node = false;
-                                break;
-                            }
-                        }                       
-                    }
-                }
-                else
-                {
-                    pos_in_domain_and_node = false;
-                }
-
-                if (pos_in_domain_and_node)
+                _training_dataset._samples.reserve(ds.size() / 2 + 1);
+                _training_dataset._labels.reserve(ds.size() / 2 + 1);
+                _testing_dataset._samples.reserve(ds.size() / 2);
+                _testing_dataset._labels.reserve(ds.size() / 2);
+                for (size_t j = 0; j < ds.size(); j++)
                 {
                     sample_type samp;
                     samp.set_size(_valuations.size());
+                    const double* x = ds.row(j);
                     for (size_t i = 0; i < _valuations.size(); i++)
                     {
-                        samp(i) = _valuations[i]->compute(*b, m);
+                        samp(i) = x[i];
                     }
-                    sc = player.domain()->get_known_score_move(*b, m, ret_mv_idx); // TB read
 
-                    if (sc != ExactScore::UNKNOWN)
-                    {
-                        // WIN_OTHER is keeping all data, WIN_LOSS is skipping DRAW score, ...
-                        if (_score_binary_class == ScoreBinaryClassifier::WIN_OTHER)
-                        {
-                            if (_training_dataset._samples.size() <= _testing_dataset._samples.size())
-                            {
-                                _training_dataset._samples.push_back(samp);
-                                {
-                                    if (sc == ExactScore::WIN) _training_dataset._labels.push_back(+1.0);
-                                    else _training_dataset._labels.push_back(-1.0);
-                                }
-                            }
-                            else
-                            {
-                                _testing_dataset._samples.push_back(samp);
-                                {
-                                    if (sc == ExactScore::WIN) _testing_dataset._labels.push_back(+1.0);
-                                    else _testing_dataset._labels.push_back(-1.0);
-                                }
-                            }
-                        }
-                        else
-                        {
-                            //...
-                        }
-                    }
+                    STRUCT_DATASET& d = (j % 2 == 0) ? _training_dataset : _testing_dataset;
+                    d._samples.push_back(samp);
+                    d._labels.push_back((ds._y[j] > 0) ? +1.0 : -1.0);
                 }
-                b = player.domain()->next_position();
-                if (b == nullptr)
-                    break;
+            }
+            else
+            {
+                //...
             }
 
             // normalize data sets
@@ -279,24 +319,17 @@ namespace chess
             _trainer.set_max_iterations(2000);
 
             if (verbose) std::cout << "doing cross validation" << std::endl;
-            for (double gamma = 0.000001; gamma <= 1; gamma *= 5)
-            {
-                _trainer.set_kernel(kernel_type(gamma));
-                if (verbose) if (verbose) std::cout << "gamma: " << gamma;
-                // Print out the cross validation accuracy for 3-fold cross validation using the current gamma.  
-                // cross_validate_trainer() returns a row vector.  The first element of the vector is the fraction
-                // of +1 training examples correctly classified and the second number is the fraction of -1 training 
-                // examples correctly classified.
-                if (verbose) std::cout << "     cross validation accuracy: " << cross_validate_trainer(_trainer, _training_dataset._samples, _training_dataset._labels, 3);
-                //matrix<double> result = cross_validate_trainer(trainer, samples, labels, 3);
-            }
-            _trainer.set_kernel(kernel_type(0.08)); // lookup best gamma...
+            _gamma = search_gamma(verbose);
+            if (verbose) std::cout << "best gamma: " << _gamma << std::endl;
+            _trainer.set_kernel(kernel_type(_gamma));
 
             _learned_function.normalizer    = _normalizer_training;
             _learned_function.function      = _trainer.train(_training_dataset._samples, _training_dataset._labels);
 
             _learned_pfunct.normalizer      = _normalizer_training;
             _learned_pfunct.function        = dlib::train_probabilistic_decision_function(_trainer, _training_dataset._samples, _training_dataset._labels, 3);
+
+            build_rff(verbose);
             return true;
         }
 
@@ -355,8 +388,289 @@ namespace chess
             _testing_dataset.clear();
         }
 
+    protected:
+        // rff_prob() - approximated _learned_pfunct(x), x raw: one fixed size pass (_rff_dim dot products and cos)
+        double rff_prob(const sample_type& x) const
+        {
+            size_t nf = (size_t)x.size();
+            double f = _rff_bias;
+            const double* omega = _rff_omega.data();
+            for (size_t k = 0; k < _rff_beta.size(); k++, omega += nf)
+            {
+                double s = _rff_phase[k];
+                for (size_t i = 0; i < nf; i++) s += omega[i] * x(i);
+                f += _rff_beta[k] * std::cos(s);
+            }
+            return 1.0 / (1.0 + std::exp(_learned_pfunct.function.alpha * f + _learned_pfunct.function.beta));
+        }
+
+        // raw_sample() - inverse of a normalizer (constant features are at their mean)
+        static sample_type raw_sample(const dlib::vector_normalizer<sample_type>& nz, const sample_type& z)
+        {
+            sample_type x = nz.means();
+            for (long i = 0; i < z.size(); i++)
+                if (nz.std_devs()(i) != 0) x(i) += z(i) / nz.std_devs()(i);
+            return x;
+        }
+
+        // build_rff() - RBF exp(-gamma|a-b|^2) has spectral density N(0, 2*gamma I): sample _rff_dim frequencies,
+        //               fit the linear weights by (ridge) least squares on the decision values of the training set,
+        //               then fold the training normalizer into the frequencies and report the error on both sets
+        void build_rff(char verbose)
+        {
+            _use_rff = false;
+            _rff_report = RffErrorReport();
+            size_t n = _training_dataset._samples.size();
+            size_t nf = _valuations.size();
+            size_t D = _rff_dim;
+            if ((D == 0) || (n == 0) || (nf == 0)) return;
+
+            std::mt19937_64 gen(_rff_seed);
+            std::normal_distribution<double> normal(0.0, std::sqrt(2.0 * _gamma));
+            std::uniform_real_distribution<double> uniform(0.0, 2.0 * 3.14159265358979323846);
+            std::vector<double> omega(D * nf);
+            std::vector<double> phase(D);
+            for (auto& v : omega) v = normal(gen);
+            for (auto& v : phase) v = uniform(gen);
+
+            // normal equations (Z'Z + ridge I) b = Z'f, Z = [cos(omega.z + phase), 1]
+            dlib::matrix<double> A(D + 1, D + 1);
+            dlib::matrix<double, 0, 1> rhs(D + 1);
+            dlib::matrix<double, 0, 1> zrow(D + 1);
+            A = 0;
+            rhs = 0;
+            for (size_t j = 0; j < n; j++)
+            {
+                const sample_type& z = _training_dataset._samples[j];
+                for (size_t k = 0; k < D; k++)
+                {
+                    double s = phase[k];
+                    for (size_t i = 0; i < nf; i++) s += omega[k * nf + i] * z(i);
+                    zrow(k) = std::cos(s);
+                }
+                zrow(D) = 1.0;
+                A += zrow * dlib::trans(zrow);
+                rhs += zrow * _learned_pfunct.function.decision_funct(z);
+            }
+            for (size_t k = 0; k <= D; k++) A(k, k) += _rff_ridge * (double)n;
+            dlib::matrix<double, 0, 1> b = dlib::cholesky_decomposition<dlib::matrix<double>>(A).solve(rhs);
+
+            // fold the training normalizer: omega.((x - m) * sd) = (omega * sd).x - omega.(m * sd)
+            const sample_type& m = _normalizer_training.means();
+            const sample_type& sd = _normalizer_training.std_devs();
+            _rff_omega.assign(D * nf, 0.0);
+            _rff_phase.assign(D, 0.0);
+            _rff_beta.assign(D, 0.0);
+            for (size_t k = 0; k < D; k++)
+            {
+                _rff_phase[k] = phase[k];
+                for (size_t i = 0; i < nf; i++)
+                {
+                    _rff_omega[k * nf + i] = omega[k * nf + i] * sd(i);
+                    _rff_phase[k] -= omega[k * nf + i] * m(i) * sd(i);
+                }
+                _rff_beta[k] = b(k);
+            }
+            _rff_bias = b(D);
+
+            // error report: probability of the approximation vs _learned_pfunct, on raw samples
+            rff_error(_training_dataset, _normalizer_training, _rff_report._train_rms, _rff_report._train_max, _rff_report._train_class_diff);
+            rff_error(_testing_dataset, _normalizer_testing, _rff_report._test_rms, _rff_report._test_max, _rff_report._test_class_diff);
+            _rff_report._dim = D;
+            _rff_report._num_basis = _learned_pfunct.function.decision_funct.basis_vectors.size();
+            // a random feature costs about one kernel evaluation: only faster with more relevance vectors than features
+            _use_rff = (_rff_report._test_rms <= _rff_max_error) && (_rff_report._num_basis > D);
+            if (verbose) std::cout << _rff_report.to_str() << (_use_rff ? " (used)" : " (not used)") << std::endl;
+        }
+
+        void rff_error(const STRUCT_DATASET& ds, const dlib::vector_normalizer<sample_type>& nz, double& ret_rms, double& ret_max, double& ret_class_diff) const
+        {
+            double sum = 0;
+            size_t ndiff = 0;
+            ret_max = 0;
+            for (size_t j = 0; j < ds._samples.size(); j++)
+            {
+                sample_type x = raw_sample(nz, ds._samples[j]);
+                double p = _learned_pfunct(x);
+                double q = rff_prob(x);
+                double e = std::abs(p - q);
+                sum += e * e;
+                ret_max = std::max<double>(ret_max, e);
+                if (score_class(p) != score_class(q)) ndiff++;
+            }
+            ret_rms = (ds._samples.size() > 0) ? std::sqrt(sum / (double)ds._samples.size()) : 0.0;
+            ret_class_diff = (ds._samples.size() > 0) ? (double)ndiff / (double)ds._samples.size() : 0.0;
+        }
+
+        static double score_class(double prob)
+        {
+            if (prob <= _FeatureManager::instance()->LOSS_THRESHOLD_IN_PROB_01()) return -1.0;
+            if (prob >= _FeatureManager::instance()->WIN_THRESHOLD_IN_PROB_01()) return +1.0;
+            return 0.0;
+        }
+
+        // search_gamma() - coarse grid (1e-6 * 5^k) on a training subset, then geometric refinement around the best
+        //                  on the same subset (on the full set only if _cv_refine_full)
+        double search_gamma(char verbose) const
+        {
+            STRUCT_DATASET coarse;
+            const STRUCT_DATASET* coarse_ds = &_training_dataset;
+            if ((_cv_coarse_size > 0) && (_training_dataset._samples.size() > _cv_coarse_size))
+            {
+                // samples already shuffled by train()
+                coarse._samples.assign(_training_dataset._samples.begin(), _training_dataset._samples.begin() + _cv_coarse_size);
+                coarse._labels.assign(_training_dataset._labels.begin(), _training_dataset._labels.begin() + _cv_coarse_size);
+                coarse_ds = &coarse;
+            }
+
+            std::vector<double> gammas;
+            std::vector<double> scores;
+            for (double gamma = 0.000001; gamma <= 1; gamma *= 5) gammas.push_back(gamma);
+            cv_scores(*coarse_ds, gammas, scores);
+
+            size_t best = 0;
+            for (size_t i = 0; i < gammas.size(); i++)
+            {
+                if (verbose) std::cout << "gamma: " << gammas[i] << "     cross validation accuracy: " << scores[i] << std::endl;
+                if (scores[i] > scores[best]) best = i;     // first best kept on ties (deterministic)
+            }
+            double best_gamma = gammas[best];
+            double best_score = scores[best];
+
+            if (_cv_refine > 0)
+            {
+                const STRUCT_DATASET* refine_ds = _cv_refine_full ? &_training_dataset : coarse_ds;
+
+                // coarse score recomputed on the full set so fine candidates compare on the same data
+                if (refine_ds != coarse_ds)
+                {
+                    gammas.assign(1, best_gamma);
+                    cv_scores(*refine_ds, gammas, scores);
+                    best_score = scores[0];
+                }
+
+                double step = std::sqrt(5.0);
+                for (size_t r = 0; r < _cv_refine; r++)
+                {
+                    gammas = { best_gamma / step, best_gamma * step };
+                    cv_scores(*refine_ds, gammas, scores);
+                    double center = best_gamma;
+                    for (size_t i = 0; i < gammas.size(); i++)
+                    {
+                        if (verbose) std::cout << "gamma: " << gammas[i] << "     cross validation accuracy: " << scores[i] << std::endl;
+                        if (scores[i] > best_score) { best_score = scores[i]; center = gammas[i]; }
+                    }
+                    best_gamma = center;
+                    step = std::sqrt(step);
+                }
+            }
+            return best_gamma;
+        }
+
+        // cv_scores() - k-fold cross validation score of each gamma (mean of +1 and -1 class accuracy)
+        // every (gamma, fold) is an independent task with its own trainer, results are merged in task order
+        static void cv_scores(const STRUCT_DATASET& ds, const std::vector<double>& gammas, std::vector<double>& ret_scores)
+        {
+            size_t nfold = _cv_folds;
+            size_t ntask = gammas.size() * nfold;
+            std::vector<FoldResult> results(ntask);
+
+            unsigned concurrency = thread_concurrency();    // capped when candidates are trained concurrently (CondValuNodeChanger)
+            if (_parallel_cv && (ntask > 1) && (concurrency > 1))
+            {
+                if (concurrency > ntask) concurrency = (unsigned)ntask;
+
+                std::atomic<size_t> next_task(0);
+                std::vector<std::future<void>> fut;
+                for (unsigned t = 0; t < concurrency; t++)
+                {
+                    fut.push_back(std::async(std::launch::async, [&]()
+                    {
+                        for (size_t k = next_task++; k < ntask; k = next_task++)
+                            results[k] = cv_fold(ds, gammas[k / nfold], k % nfold, nfold);
+                    }));
+                }
+                for (auto& f : fut) f.get();
+            }
+            else
+            {
+                for (size_t k = 0; k < ntask; k++)
+                    results[k] = cv_fold(ds, gammas[k / nfold], k % nfold, nfold);
+            }
+
+            ret_scores.assign(gammas.size(), 0.0);
+            for (size_t g = 0; g < gammas.size(); g++)
+            {
+                FoldResult sum;
+                for (size_t f = 0; f < nfold; f++)
+                {
+                    const FoldResult& r = results[g * nfold + f];
+                    sum._pos += r._pos;  sum._pos_ok += r._pos_ok;
+                    sum._neg += r._neg;  sum._neg_ok += r._neg_ok;
+                }
+                double acc_pos = (sum._pos > 0) ? (double)sum._pos_ok / (double)sum._pos : 0.0;
+                double acc_neg = (sum._neg > 0) ? (double)sum._neg_ok / (double)sum._neg : 0.0;
+                ret_scores[g] = (acc_pos + acc_neg) / 2.0;
+            }
+        }
+
+        // cv_fold() - train on all samples but fold (i % nfold == fold), test on fold
+        static FoldResult cv_fold(const STRUCT_DATASET& ds, double gamma, size_t fold, size_t nfold)
+        {
+            FoldResult res;
+            std::vector<sample_type> samples;
+            std::vector<double>      labels;
+            for (size_t i = 0; i < ds._samples.size(); i++)
+            {
+                if (i % nfold == fold) continue;
+                samples.push_back(ds._samples[i]);
+                labels.push_back(ds._labels[i]);
+            }
+
+            dlib::rvm_trainer<kernel_type> trainer;     // own trainer (dlib trainers are not shared between threads)
+            trainer.set_epsilon(0.001);
+            trainer.set_max_iterations(2000);
+            trainer.set_kernel(kernel_type(gamma));
+            try
+            {
+                dec_funct_type df = trainer.train(samples, labels);
+                for (size_t i = fold; i < ds._samples.size(); i += nfold)
+                {
+                    bool ok = ((df(ds._samples[i]) >= 0) == (ds._labels[i] > 0));
+                    if (ds._labels[i] > 0)  { res._pos++; if (ok) res._pos_ok++; }
+                    else                    { res._neg++; if (ok) res._neg_ok++; }
+                }
+            }
+            catch (std::exception& re)
+            {
+                std::stringstream ss_detail;
+                ss_detail << re.what() << "\n";
+                std::cerr << ss_detail.str();
+            }
+            return res;
+        }
+
     };
 
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    size_t FeatureValuAlgo_rvm_trainer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::_cv_folds = 3;
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    size_t FeatureValuAlgo_rvm_trainer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::_cv_coarse_size = 5000;
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    size_t FeatureValuAlgo_rvm_trainer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::_cv_refine = 2;
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    bool FeatureValuAlgo_rvm_trainer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::_cv_refine_full = false;
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    bool FeatureValuAlgo_rvm_trainer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::_parallel_cv = true;
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    size_t FeatureValuAlgo_rvm_trainer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::_rff_dim = 256;
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    double FeatureValuAlgo_rvm_trainer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::_rff_max_error = 0.02;
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    double FeatureValuAlgo_rvm_trainer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::_rff_ridge = 1e-8;
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    uint64_t FeatureValuAlgo_rvm_trainer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::_rff_seed = 1;
+
 };
 
 #endif
@@ -0,0 +1,379 @@
+#pragma once
+//=================================================================================================
+//                    Copyright (C) 2017 Alain Lanthier - All Rights Reserved                      
+//=================================================================================================
+//
+// FeatureValuAlgo_svm_c_linear_dcd_trainer<...> : linear SVM (dual coordinate descent) valuation
+//
+// Training is linear in the number of samples and can be warm started: when the dataset grows by
+// appending positions (FeatureDatasetBuilder returns the first n positions in domain index order, so a
+// larger max_size_dataset appends) or by add_samples(), retraining starts from the previous optimizer
+// state. The model is folded back to raw feature space so an evaluation is a single dot product
+// followed by a Platt sigmoid.
+//
+#ifndef _AL_CHESS_FEATURE_FeatureValuAlgo_svm_c_linear_dcd_trainer_HPP
+#define _AL_CHESS_FEATURE_FeatureValuAlgo_svm_c_linear_dcd_trainer_HPP
+
+#include <ExternLib/dlib/svm.h>
+
+namespace chess
+{
+    // FeatureValuAlgo_svm_c_linear_dcd_trainer
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    class FeatureValuAlgo_svm_c_linear_dcd_trainer : public FeatureValuAlgo<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>
+    {
+        using _Board    = Board<PieceID, _BoardSize>;
+        using _Move     = Move<PieceID>;
+        using _FeatureManager   = FeatureManager<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _ValuationFeature = ValuationFeature<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _ConditionValuationNode = ConditionValuationNode<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _FeatureAlgo          = FeatureAlgo<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _FeatureValuAlgo      = FeatureValuAlgo<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _FeatureAlgoConfig    = FeatureAlgoConfig<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _DomainPlayer         = DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _FeatureDatasetBuilder = FeatureDatasetBuilder<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+
+    private:
+        typedef dlib::matrix<double, 0, 1>                          sample_type;
+        typedef dlib::linear_kernel<sample_type>                    kernel_type;
+        typedef dlib::decision_function<kernel_type>                dec_funct_type;
+        typedef dlib::svm_c_linear_dcd_trainer<kernel_type>         trainer_type;
+        typedef typename trainer_type::optimizer_state              state_type;
+        struct STRUCT_DATASET
+        {
+            std::vector<sample_type>    _samples;   // normalized
+            std::vector<double>         _labels;
+            void clear()
+            {
+                _samples.clear();
+                _labels.clear();
+            }
+        };
+
+        std::vector<_ValuationFeature*>         _valuations;
+
+        // model in raw feature space: f(x) = _w.x - _b, prob = 1/(1+exp(_platt_a*f + _platt_b))
+        std::vector<double>                     _w;
+        double                                  _b = 0;
+        double                                  _platt_a = -1;
+        double                                  _platt_b = 0;
+
+        // warm start state (kept between trainings unless _keep_warm_state is false)
+        dlib::vector_normalizer<sample_type>    _normalizer;        // fixed at the first training, required by warm start
+        state_type                              _state;
+        bool                                    _has_state = false;
+        std::vector<sample_type>                _training_raw;      // raw rows of _training_dataset (prefix check)
+        STRUCT_DATASET                          _training_dataset;
+        STRUCT_DATASET                          _testing_dataset;   // raw
+
+        static double                           _C;
+        static bool                             _keep_warm_state;
+
+    public:
+        FeatureValuAlgo_svm_c_linear_dcd_trainer(const _FeatureAlgoConfig& cfg) : _FeatureValuAlgo(cfg)
+        {
+        }
+        ~FeatureValuAlgo_svm_c_linear_dcd_trainer() {}
+
+        _FeatureAlgo* clone() const override { return new FeatureValuAlgo_svm_c_linear_dcd_trainer(*this); }
+
+        static void set_C(double c)                 { _C = c; }
+        static void set_keep_warm_state(bool v)     { _keep_warm_state = v; }
+        bool        has_warm_state() const          { return _has_state; }
+
+        TYPE_PARAM get_valuations_value(const _Board& position, const std::vector<_Move>& m, char verbose, std::stringstream& verbose_stream) const override
+        {
+            std::vector<TYPE_PARAM> values;
+            _ValuationFeature::compute_all(position, m, _valuations, values);
+            double f = -_b;
+            for (size_t i = 0; i < _w.size(); i++) f += _w[i] * (double)values[i];
+            return (TYPE_PARAM)dlib::platt_scale(std::make_pair(_platt_a, _platt_b), f);
+        }
+
+        // add_samples() - append new labelled positions (rows of _valuations) to the training set, retrain() to warm start
+        bool add_samples(const FeatureDataset& ds)
+        {
+            if (ds._nfeature != _valuations.size()) return false;
+            bool init = (_training_raw.size() == 0);
+            for (size_t j = 0; j < ds.size(); j++)
+            {
+                sample_type samp = to_sample(ds.row(j));
+                _training_raw.push_back(samp);
+                _training_dataset._labels.push_back((ds._y[j] > 0) ? +1.0 : -1.0);
+                if (!init) _training_dataset._samples.push_back(_normalizer(samp));
+            }
+            if (init) reset_training_set();
+            return true;
+        }
+
+        bool retrain(char verbose) { return fit(verbose); }
+
+        bool load() override
+        {
+            std::string f = PersistManager<PieceID, _BoardSize>::instance()->get_stream_name("ConditionValuationNode", cfg()._persist_key);
+            std::ifstream is;
+            is.open(f.c_str(), std::fstream::in);
+            if (!load_cfg(is))
+            {
+                is.close();
+                return true;
+            }
+            if (!load_detail(is))
+            {
+                is.close();
+                return true;
+            }
+            is.close();
+            return false;
+        }
+
+        bool load_cfg(std::ifstream& is) override
+        {
+            if (is.good())
+            {
+                cfg().load_detail(is);
+                return true;
+            }
+            return false;
+        }
+
+        bool load_detail(std::ifstream& is) override
+        {
+            for (size_t i = 0; i < _valuations.size(); i++) _valuations[i] = nullptr; // not owner
+            _valuations.clear();
+            size_t n;
+            is >> n;
+            for (size_t i = 0; i < n; i++)
+            {
+                _ValuationFeature* feature = read_valu(is);
+                if (feature == nullptr) return false;
+                _valuations.push_back(feature);
+            }
+
+            _w.clear();
+            is >> n;
+            for (size_t i = 0; i < n; i++)
+            {
+                double v; is >> v;
+                _w.push_back(v);
+            }
+            is >> _b;
+            is >> _platt_a;
+            is >> _platt_b;
+            return is.good();
+        }
+
+        bool save() const override
+        {
+            if (cfg()._persist_key.size() == 0)
+                cfg()._persist_key = PersistManager<PieceID, _BoardSize>::instance()->create_persist_key();
+            std::string f = PersistManager<PieceID, _BoardSize>::instance()->get_stream_name("ConditionValuationNode", cfg()._persist_key);
+            std::ofstream os;
+            os.open(f.c_str(), std::fstream::out | std::fstream::trunc);
+            if (save_detail(os))
+            {
+                os.close();
+                return true;
+            }
+            os.close();
+            return false;
+        }
+
+        bool save_detail(std::ofstream& os) const override
+        {
+            if (os.good())
+            {
+                cfg().save_detail(os);
+                os << _valuations.size();   os << " ";
+                for (auto& v : _valuations) v->save(os);
+                os << std::setprecision(17);
+                os << _w.size();            os << " ";
+                for (auto& v : _w)          { os << v; os << " "; }
+                os << _b;                   os << " ";
+                os << _platt_a;             os << " ";
+                os << _platt_b;             os << " ";
+                return true;
+            }
+            return false;
+        }
+
+        // prepare
+        bool prepare(_DomainPlayer& player, _ConditionValuationNode* node, size_t max_size_dataset) override
+        {
+            std::vector<_ValuationFeature*> valuations;
+            _ValuationFeature* f;
+            for (size_t i = 0; i < cfg()._valu_primitive_features.size(); i++)
+            {
+                f = _FeatureManager::instance()->get_valu_feature_by_fullname(cfg()._valu_primitive_features[i]);
+                if (f != nullptr) valuations.push_back(f);
+            }
+            if (valuations != _valuations) clear_warm_state();
+            _valuations = valuations;
+
+            // same split as rvm_trainer: 2n-1 positions alternated training/testing
+            FeatureDataset ds;
+            size_t max_samples = (max_size_dataset > 0) ? 2 * max_size_dataset - 1 : 0;
+            if (!_FeatureDatasetBuilder::build(player, node, _valuations, max_samples, ds))
+                return false;
+
+            std::vector<sample_type> train_raw;
+            std::vector<double>      train_labels;
+            _testing_dataset.clear();
+            for (size_t j = 0; j < ds.size(); j++)
+            {
+                double label = (ds._y[j] > 0) ? +1.0 : -1.0;
+                if (j % 2 == 0)
+                {
+                    train_raw.push_back(to_sample(ds.row(j)));
+                    train_labels.push_back(label);
+                }
+                else
+                {
+                    _testing_dataset._samples.push_back(to_sample(ds.row(j)));
+                    _testing_dataset._labels.push_back(label);
+                }
+            }
+
+            // warm start if the previous training set is a prefix of the new one
+            bool is_prefix = _has_state && (train_raw.size() >= _training_raw.size());
+            for (size_t i = 0; is_prefix && (i < _training_raw.size()); i++)
+            {
+                if ((train_labels[i] != _training_dataset._labels[i]) || (train_raw[i] != _training_raw[i])) is_prefix = false;
+            }
+
+            if (is_prefix)
+            {
+                for (size_t i = _training_raw.size(); i < train_raw.size(); i++)
+                {
+                    _training_dataset._samples.push_back(_normalizer(train_raw[i]));
+                    _training_dataset._labels.push_back(train_labels[i]);
+                }
+                _training_raw.swap(train_raw);
+            }
+            else
+            {
+                clear_warm_state();
+                _training_raw.swap(train_raw);
+                _training_dataset._labels.swap(train_labels);
+                reset_training_set();
+            }
+            return true;
+        }
+
+        bool train(_DomainPlayer& player, _ConditionValuationNode* node, size_t max_size_dataset, char verbose) override
+        {
+            return fit(verbose);
+        }
+
+        bool test(_DomainPlayer& player, _ConditionValuationNode* node, size_t max_size_dataset) override
+        {
+            this->cfg()._train_dataset_average_error = rmse(_training_raw, _training_dataset._labels);
+            this->cfg()._test_dataset_average_error  = rmse(_testing_dataset._samples, _testing_dataset._labels);
+            return true;
+        }
+
+        bool compare(_DomainPlayer& player, _ConditionValuationNode* node, size_t max_size_dataset) override
+        {
+            if (node->current_valu_algo() == nullptr) return true;
+            if (node->test_valu_algo()->cfg()._test_dataset_average_error <= node->current_valu_algo()->cfg()._test_dataset_average_error)
+                return true; // can change algo on node (since better performance)
+            return false;
+        }
+
+        void cleanup(_DomainPlayer& player, _ConditionValuationNode* node, size_t max_size_dataset) override
+        {
+            _testing_dataset.clear();
+            if (!_keep_warm_state) clear_warm_state();
+        }
+
+    protected:
+        sample_type to_sample(const double* x) const
+        {
+            sample_type samp;
+            samp.set_size(_valuations.size());
+            for (size_t i = 0; i < _valuations.size(); i++) samp(i) = x[i];
+            return samp;
+        }
+
+        void clear_warm_state()
+        {
+            _state = state_type();
+            _has_state = false;
+            _training_raw.clear();
+            _training_dataset.clear();
+        }
+
+        // reset_training_set() - new normalizer on _training_raw (cold start)
+        void reset_training_set()
+        {
+            _state = state_type();
+            _has_state = false;
+            _training_dataset._samples.clear();
+            if (_training_raw.size() == 0) return;
+            _normalizer.train(_training_raw);
+            for (size_t i = 0; i < _training_raw.size(); i++)
+                _training_dataset._samples.push_back(_normalizer(_training_raw[i]));
+        }
+
+        // fit() - (warm started) training, Platt scaling and folding of the normalizer into raw weights
+        bool fit(char verbose)
+        {
+            if (!dlib::is_binary_classification_problem(_training_dataset._samples, _training_dataset._labels)) return false;
+
+            trainer_type trainer(_C);
+            if (verbose) std::cout << "svm_c_linear_dcd: " << _training_dataset._samples.size() << " samples" << (_has_state ? " (warm start)" : "") << std::endl;
+            dec_funct_type df = trainer.train(_training_dataset._samples, _training_dataset._labels, _state);
+            _has_state = true;
+
+            std::vector<double> scores(_training_dataset._samples.size());
+            for (size_t i = 0; i < scores.size(); i++) scores[i] = df(_training_dataset._samples[i]);
+            std::pair<double, double> platt = dlib::learn_platt_scaling(scores, _training_dataset._labels);
+            _platt_a = platt.first;
+            _platt_b = platt.second;
+
+            // f(x) = w.((x-m)*sd) - b = (w*sd).x - (w.(m*sd) + b)
+            const sample_type& w = df.basis_vectors(0);
+            const sample_type& m = _normalizer.means();
+            const sample_type& sd = _normalizer.std_devs();
+            _w.assign(_valuations.size(), 0.0);
+            _b = df.b;
+            for (size_t i = 0; i < _valuations.size(); i++)
+            {
+                _w[i] = w(i) * sd(i);
+                _b += w(i) * m(i) * sd(i);
+            }
+            return true;
+        }
+
+        double raw_decision(const sample_type& x) const
+        {
+            double f = -_b;
+            for (size_t i = 0; i < _w.size(); i++) f += _w[i] * x(i);
+            return f;
+        }
+
+        // rmse() - class error (thresholds of FeatureManager) on raw samples
+        double rmse(const std::vector<sample_type>& samples, const std::vector<double>& labels) const
+        {
+            double sum_err = 0;
+            double score_class;
+            for (size_t i = 0; i < samples.size(); i++)
+            {
+                double prob = dlib::platt_scale(std::make_pair(_platt_a, _platt_b), raw_decision(samples[i]));
+                if (prob <= _FeatureManager::instance()->LOSS_THRESHOLD_IN_PROB_01()) score_class = -1.0;
+                else if (prob >= _FeatureManager::instance()->WIN_THRESHOLD_IN_PROB_01()) score_class = +1.0;
+                else score_class = 0.0;
+                sum_err += std::pow(std::abs(labels[i] - score_class), 2);
+            }
+            sum_err = sum_err / (1 + samples.size());   // 1+n (in case n==0)
+            return std::pow(sum_err, 0.5);              // root-mean-square error (RMSE)
+        }
+    };
+
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    double FeatureValuAlgo_svm_c_linear_dcd_trainer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::_C = 1.0;
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    bool FeatureValuAlgo_svm_c_linear_dcd_trainer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::_keep_warm_state = true;
+};
+
+#endif
@@ -25,25 +25,38 @@ namespace chess
         using _FeatureValuAlgo = FeatureValuAlgo<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
         using _FeatureAlgoConfig = FeatureAlgoConfig<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
         using _DomainPlayer = DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _FeatureTexelTuner = FeatureTexelTuner<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
     
     protected:
         std::vector<_ValuationFeature*> _valuations;
         std::vector<TYPE_PARAM>         _weights;
 
+        static bool                     _texel_train;   // train() fits the weights on TB labelled positions (TexelTuner, opt-in)
+
     public:
         FeatureValuAlgo_weight_sum(const _FeatureAlgoConfig& cfg) : _FeatureValuAlgo(cfg)
         {
         }
         ~FeatureValuAlgo_weight_sum() {}
 
+        _FeatureAlgo* clone() const override { return new FeatureValuAlgo_weight_sum(*this); }
+
+        const std::vector<_ValuationFeature*>&  valuations()    const { return _valuations; }
+        const std::vector<TYPE_PARAM>&          weights()       const { return _weights; }
+        void set_weights(const std::vector<TYPE_PARAM>& w)            { _weights = w; }
+
+        static void set_texel_train(bool v) { _texel_train = v; }
+
         TYPE_PARAM get_valuations_value(const _Board& position, const std::vector<_Move>& m, char verbose, std::stringstream& verbose_stream) const override
         { 
             assert(_weights.size() >= _valuations.size());
             TYPE_PARAM c = 0;
             TYPE_PARAM v = 0;
+            std::vector<TYPE_PARAM> values;
+            _ValuationFeature::compute_all(position, m, _valuations, values);    // single pass over a shared context
             for (size_t i = 0; i < _valuations.size(); i++)
             {
-                v = _valuations[i]->compute(position, m);
+                v = values[i];
                 c += (v * _weights[i]);
                 if (verbose > 2)
                 {
@@ -54,6 +67,37 @@ namespace chess
             return sigmoid(c);
         }
 
+        // get_valuations_value_batch() - same as get_valuations_value() for N positions at once (SIMD)
+        void get_valuations_value_batch(const FeatureMatrix& X, std::vector<TYPE_PARAM>& ret_values) const
+        {
+            assert(X.ncol() == _valuations.size());
+            std::vector<double> w(_weights.begin(), _weights.begin() + _valuations.size());
+            std::vector<double> out;
+            BatchEvaluator::weight_sum_sigmoid(X, w, SIGMOID_SCALE, out);
+            ret_values.assign(out.begin(), out.end());
+        }
+
+        void get_valuations_value_batch(const std::vector<_Board>& positions, std::vector<TYPE_PARAM>& ret_values) const
+        {
+            FeatureMatrix X;
+            make_feature_matrix(positions, X);
+            get_valuations_value_batch(X, ret_values);
+        }
+
+        // make_feature_matrix() - one row of valuation features per position
+        void make_feature_matrix(const std::vector<_Board>& positions, FeatureMatrix& X) const
+        {
+            X.resize(positions.size(), _valuations.size());
+            std::vector<TYPE_PARAM> values;
+            for (size_t j = 0; j < positions.size(); j++)
+            {
+                _Board b = positions[j];
+                std::vector<_Move> m = b.generate_moves();
+                _ValuationFeature::compute_all(b, m, _valuations, values);
+                X.set_row(j, values);
+            }
+        }
+
         bool load() override
         {
             std::string f = PersistManager<PieceID, _BoardSize>::instance()->get_stream_name("ConditionValuationNode", cfg()._persist_key);
@@ -160,7 +204,9 @@ namespace chess
 
         bool train(_DomainPlayer& player, _ConditionValuationNode* node, size_t max_size_dataset, char verbose) override
         {
-            //... GA
+            // supervised start point, the GA can refine from there
+            if (_texel_train)
+                return _FeatureTexelTuner::tune(player, node, *this, max_size_dataset, verbose);
             return true;
         }
 
@@ -183,6 +229,9 @@ namespace chess
 
     };
 
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    bool FeatureValuAlgo_weight_sum<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::_texel_train = false;
+
 };
 
 #endif
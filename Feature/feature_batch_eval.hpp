@@ -0,0 +1,318 @@
+#pragma once
+//=================================================================================================
+//                    Copyright (C) 2017 Alain Lanthier - All Rights Reserved                      
+//=================================================================================================
+//
+// FeatureMatrix    : dense structure-of-arrays (feature major) matrix of N positions x F features
+// BatchEvaluator   : sigmoid(a * sum_f(w[f] * X[f][j])) for all positions j at once
+//
+// Vectorized across positions (SSE2 2x, AVX2 4x, AVX-512 8x doubles) with runtime CPU dispatch
+// and a scalar fallback. Every path does the same IEEE operations in the same order (features
+// accumulated in ascending order, no FMA, same exp polynomial) so results are bit identical
+// whatever instruction set is selected (when built without floating point contraction,
+// the MSVC /fp:precise default).
+//
+#ifndef _AL_CHESS_FEATURE_FEATURE_BATCH_EVAL_HPP
+#define _AL_CHESS_FEATURE_FEATURE_BATCH_EVAL_HPP
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define _AL_CHESS_SIMD_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+#endif
+
+#if defined(_AL_CHESS_SIMD_X86) && defined(__clang__)
+#define _AL_CHESS_TARGET_AVX2   __attribute__((target("avx2")))
+#define _AL_CHESS_TARGET_AVX512 __attribute__((target("avx512f")))
+#elif defined(_AL_CHESS_SIMD_X86) && defined(__GNUC__)
+// avx512f implies FMA: keep mul/add separate (no contraction) to stay bit identical with other paths
+#define _AL_CHESS_TARGET_AVX2   __attribute__((target("avx2"), optimize("fp-contract=off")))
+#define _AL_CHESS_TARGET_AVX512 __attribute__((target("avx512f"), optimize("fp-contract=off")))
+#else
+#define _AL_CHESS_TARGET_AVX2
+#define _AL_CHESS_TARGET_AVX512
+#endif
+
+namespace chess
+{
+    const double SIGMOID_SCALE = 0.001;     // a of sigmoid(a * x) of the valuations (weight_sum, batch and tuners)
+
+    enum class SimdLevel { scalar = 0, sse2 = 1, avx2 = 2, avx512 = 3 };
+
+    // FeatureMatrix
+    class FeatureMatrix
+    {
+    public:
+        FeatureMatrix(size_t nrow = 0, size_t ncol = 0) { resize(nrow, ncol); }
+
+        // rows padded to a multiple of 8 so every kernel can run full vectors
+        void resize(size_t nrow, size_t ncol)
+        {
+            _nrow = nrow;
+            _ncol = ncol;
+            _stride = (nrow + 7) & ~((size_t)7);
+            _data.assign(_stride * ncol, 0.0);
+        }
+
+        template <typename T>
+        void set_row(size_t row, const std::vector<T>& values)
+        {
+            assert(values.size() >= _ncol);
+            for (size_t f = 0; f < _ncol; f++) _data[f * _stride + row] = (double)values[f];
+        }
+
+        double&         at(size_t row, size_t f)        { return _data[f * _stride + row]; }
+        double          at(size_t row, size_t f) const  { return _data[f * _stride + row]; }
+        const double*   col(size_t f) const             { return _data.data() + f * _stride; }
+        size_t          nrow()      const { return _nrow; }
+        size_t          ncol()      const { return _ncol; }
+        size_t          stride()    const { return _stride; }
+
+    private:
+        size_t              _nrow;
+        size_t              _ncol;
+        size_t              _stride;
+        std::vector<double> _data;
+    };
+
+    // BatchEvaluator
+    class BatchEvaluator
+    {
+    public:
+        static SimdLevel detect();
+        static SimdLevel level()                { return (forced_level() >= 0) ? (SimdLevel)forced_level() : detected_level(); }
+        static void      force_level(SimdLevel l) { forced_level() = (int)l; }  // capped to what the CPU supports
+        static void      reset_level()          { forced_level() = -1; }
+
+        // ret[j] = sigmoid(sum_f(w[f] * X(j,f)), a) for j in [0, X.nrow())
+        static void weight_sum_sigmoid(const FeatureMatrix& X, const std::vector<double>& w, double a, std::vector<double>& ret);
+
+        // same exp/sigmoid approximation as the vector kernels (scalar reference)
+        static double exp_approx(double x);
+        static double sigmoid_approx(double x, double a) { return 1.0 / (1.0 + exp_approx(-a * x)); }
+
+    private:
+        static SimdLevel detected_level()
+        {
+            static const SimdLevel l = detect();
+            return l;
+        }
+        static int& forced_level()
+        {
+            static int l = -1;
+            return l;
+        }
+
+        static void kernel_scalar(const FeatureMatrix& X, const double* w, double a, double* out);
+#ifdef _AL_CHESS_SIMD_X86
+        static void kernel_sse2(const FeatureMatrix& X, const double* w, double a, double* out);
+        _AL_CHESS_TARGET_AVX2   static void kernel_avx2(const FeatureMatrix& X, const double* w, double a, double* out);
+        _AL_CHESS_TARGET_AVX512 static void kernel_avx512(const FeatureMatrix& X, const double* w, double a, double* out);
+#endif
+    };
+
+    // exp approximation constants: x = n*ln2 + r, |r| <= ln2/2, exp(r) degree 11 Taylor (rel err ~1e-15)
+    namespace batch_eval_const
+    {
+        const double EXP_MAX    = 708.0;
+        const double LOG2E      = 1.4426950408889634;
+        const double LN2_HI     = 6.93145751953125e-1;
+        const double LN2_LO     = 1.42860682030941723212e-6;
+        const double ROUND_MAGIC = 6755399441055744.0;      // 1.5 * 2^52 : x + magic rounds x to nearest integer in the low mantissa bits
+        const int64_t ROUND_MAGIC_BITS = 0x4338000000000000LL;
+        const double C[12] = {  1.0, 1.0, 1.0 / 2, 1.0 / 6, 1.0 / 24, 1.0 / 120, 1.0 / 720, 1.0 / 5040,
+                                1.0 / 40320, 1.0 / 362880, 1.0 / 3628800, 1.0 / 39916800 };
+    };
+
+    // detect() - highest instruction set supported by CPU and OS (saved register state)
+    inline SimdLevel BatchEvaluator::detect()
+    {
+#ifdef _AL_CHESS_SIMD_X86
+        unsigned int r1[4] = { 0, 0, 0, 0 };    // eax ebx ecx edx
+        unsigned int r7[4] = { 0, 0, 0, 0 };
+        unsigned int max_leaf;
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0); max_leaf = (unsigned int)info[0];
+        __cpuid(info, 1); for (size_t i = 0; i < 4; i++) r1[i] = (unsigned int)info[i];
+        if (max_leaf >= 7) { __cpuidex(info, 7, 0); for (size_t i = 0; i < 4; i++) r7[i] = (unsigned int)info[i]; }
+#else
+        max_leaf = __get_cpuid_max(0, nullptr);
+        __cpuid(1, r1[0], r1[1], r1[2], r1[3]);
+        if (max_leaf >= 7) __cpuid_count(7, 0, r7[0], r7[1], r7[2], r7[3]);
+#endif
+        bool sse2 = (r1[3] & (1u << 26)) != 0;
+        bool osxsave = (r1[2] & (1u << 27)) != 0;
+        uint64_t xcr0 = 0;
+        if (osxsave)
+        {
+#if defined(_MSC_VER)
+            xcr0 = _xgetbv(0);
+#else
+            unsigned int lo, hi;
+            __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+            xcr0 = ((uint64_t)hi << 32) | lo;
+#endif
+        }
+        bool ymm_os = (xcr0 & 0x06) == 0x06;
+        bool zmm_os = (xcr0 & 0xE6) == 0xE6;
+        bool avx2 = ymm_os && ((r7[1] & (1u << 5)) != 0);
+        bool avx512 = zmm_os && ((r7[1] & (1u << 16)) != 0);
+
+        if (avx512)     return SimdLevel::avx512;
+        if (avx2)       return SimdLevel::avx2;
+        if (sse2)       return SimdLevel::sse2;
+#endif
+        return SimdLevel::scalar;
+    }
+
+    // exp_approx()
+    inline double BatchEvaluator::exp_approx(double x)
+    {
+        using namespace batch_eval_const;
+        x = std::min(std::max(x, -EXP_MAX), EXP_MAX);
+        double t = x * LOG2E + ROUND_MAGIC;
+        double n = t - ROUND_MAGIC;
+        double r = x - n * LN2_HI;
+        r = r - n * LN2_LO;
+        double p = C[11];
+        for (int i = 10; i >= 0; i--) p = p * r + C[i];
+
+        int64_t tb;
+        std::memcpy(&tb, &t, sizeof(tb));
+        int64_t eb = (tb - ROUND_MAGIC_BITS + 1023) << 52;
+        double scale;
+        std::memcpy(&scale, &eb, sizeof(scale));
+        return p * scale;
+    }
+
+    // weight_sum_sigmoid()
+    inline void BatchEvaluator::weight_sum_sigmoid(const FeatureMatrix& X, const std::vector<double>& w, double a, std::vector<double>& ret)
+    {
+        assert(w.size() >= X.ncol());
+        std::vector<double> out(X.stride(), 0.0);
+        SimdLevel l = std::min(level(), detected_level());
+        switch (l)
+        {
+#ifdef _AL_CHESS_SIMD_X86
+        case SimdLevel::avx512: kernel_avx512(X, w.data(), a, out.data()); break;
+        case SimdLevel::avx2:   kernel_avx2(X, w.data(), a, out.data()); break;
+        case SimdLevel::sse2:   kernel_sse2(X, w.data(), a, out.data()); break;
+#endif
+        default:                kernel_scalar(X, w.data(), a, out.data()); break;
+        }
+        ret.assign(out.begin(), out.begin() + X.nrow());
+    }
+
+    // kernel_scalar()
+    inline void BatchEvaluator::kernel_scalar(const FeatureMatrix& X, const double* w, double a, double* out)
+    {
+        for (size_t f = 0; f < X.ncol(); f++)
+        {
+            const double* c = X.col(f);
+            for (size_t j = 0; j < X.stride(); j++) out[j] = out[j] + w[f] * c[j];
+        }
+        for (size_t j = 0; j < X.stride(); j++) out[j] = sigmoid_approx(out[j], a);
+    }
+
+#ifdef _AL_CHESS_SIMD_X86
+    // kernel_sse2()
+    inline void BatchEvaluator::kernel_sse2(const FeatureMatrix& X, const double* w, double a, double* out)
+    {
+        using namespace batch_eval_const;
+        for (size_t f = 0; f < X.ncol(); f++)
+        {
+            const double* c = X.col(f);
+            __m128d vw = _mm_set1_pd(w[f]);
+            for (size_t j = 0; j < X.stride(); j += 2)
+                _mm_storeu_pd(out + j, _mm_add_pd(_mm_loadu_pd(out + j), _mm_mul_pd(vw, _mm_loadu_pd(c + j))));
+        }
+
+        const __m128d vna = _mm_set1_pd(-a);
+        const __m128d one = _mm_set1_pd(1.0);
+        const __m128i magic_bits = _mm_set1_epi64x(ROUND_MAGIC_BITS - 1023);
+        for (size_t j = 0; j < X.stride(); j += 2)
+        {
+            __m128d x = _mm_mul_pd(vna, _mm_loadu_pd(out + j));
+            x = _mm_min_pd(_mm_max_pd(x, _mm_set1_pd(-EXP_MAX)), _mm_set1_pd(EXP_MAX));
+            __m128d t = _mm_add_pd(_mm_mul_pd(x, _mm_set1_pd(LOG2E)), _mm_set1_pd(ROUND_MAGIC));
+            __m128d n = _mm_sub_pd(t, _mm_set1_pd(ROUND_MAGIC));
+            __m128d r = _mm_sub_pd(x, _mm_mul_pd(n, _mm_set1_pd(LN2_HI)));
+            r = _mm_sub_pd(r, _mm_mul_pd(n, _mm_set1_pd(LN2_LO)));
+            __m128d p = _mm_set1_pd(C[11]);
+            for (int i = 10; i >= 0; i--) p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(C[i]));
+            __m128d scale = _mm_castsi128_pd(_mm_slli_epi64(_mm_sub_epi64(_mm_castpd_si128(t), magic_bits), 52));
+            __m128d e = _mm_mul_pd(p, scale);
+            _mm_storeu_pd(out + j, _mm_div_pd(one, _mm_add_pd(one, e)));
+        }
+    }
+
+    // kernel_avx2()
+    _AL_CHESS_TARGET_AVX2 inline void BatchEvaluator::kernel_avx2(const FeatureMatrix& X, const double* w, double a, double* out)
+    {
+        using namespace batch_eval_const;
+        for (size_t f = 0; f < X.ncol(); f++)
+        {
+            const double* c = X.col(f);
+            __m256d vw = _mm256_set1_pd(w[f]);
+            for (size_t j = 0; j < X.stride(); j += 4)
+                _mm256_storeu_pd(out + j, _mm256_add_pd(_mm256_loadu_pd(out + j), _mm256_mul_pd(vw, _mm256_loadu_pd(c + j))));
+        }
+
+        const __m256d vna = _mm256_set1_pd(-a);
+        const __m256d one = _mm256_set1_pd(1.0);
+        const __m256i magic_bits = _mm256_set1_epi64x(ROUND_MAGIC_BITS - 1023);
+        for (size_t j = 0; j < X.stride(); j += 4)
+        {
+            __m256d x = _mm256_mul_pd(vna, _mm256_loadu_pd(out + j));
+            x = _mm256_min_pd(_mm256_max_pd(x, _mm256_set1_pd(-EXP_MAX)), _mm256_set1_pd(EXP_MAX));
+            __m256d t = _mm256_add_pd(_mm256_mul_pd(x, _mm256_set1_pd(LOG2E)), _mm256_set1_pd(ROUND_MAGIC));
+            __m256d n = _mm256_sub_pd(t, _mm256_set1_pd(ROUND_MAGIC));
+            __m256d r = _mm256_sub_pd(x, _mm256_mul_pd(n, _mm256_set1_pd(LN2_HI)));
+            r = _mm256_sub_pd(r, _mm256_mul_pd(n, _mm256_set1_pd(LN2_LO)));
+            __m256d p = _mm256_set1_pd(C[11]);
+            for (int i = 10; i >= 0; i--) p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(C[i]));
+            __m256d scale = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_sub_epi64(_mm256_castpd_si256(t), magic_bits), 52));
+            __m256d e = _mm256_mul_pd(p, scale);
+            _mm256_storeu_pd(out + j, _mm256_div_pd(one, _mm256_add_pd(one, e)));
+        }
+    }
+
+    // kernel_avx512()
+    _AL_CHESS_TARGET_AVX512 inline void BatchEvaluator::kernel_avx512(const FeatureMatrix& X, const double* w, double a, double* out)
+    {
+        using namespace batch_eval_const;
+        for (size_t f = 0; f < X.ncol(); f++)
+        {
+            const double* c = X.col(f);
+            __m512d vw = _mm512_set1_pd(w[f]);
+            for (size_t j = 0; j < X.stride(); j += 8)
+                _mm512_storeu_pd(out + j, _mm512_add_pd(_mm512_loadu_pd(out + j), _mm512_mul_pd(vw, _mm512_loadu_pd(c + j))));
+        }
+
+        const __m512d vna = _mm512_set1_pd(-a);
+        const __m512d one = _mm512_set1_pd(1.0);
+        const __m512i magic_bits = _mm512_set1_epi64(ROUND_MAGIC_BITS - 1023);
+        for (size_t j = 0; j < X.stride(); j += 8)
+        {
+            __m512d x = _mm512_mul_pd(vna, _mm512_loadu_pd(out + j));
+            x = _mm512_min_pd(_mm512_max_pd(x, _mm512_set1_pd(-EXP_MAX)), _mm512_set1_pd(EXP_MAX));
+            __m512d t = _mm512_add_pd(_mm512_mul_pd(x, _mm512_set1_pd(LOG2E)), _mm512_set1_pd(ROUND_MAGIC));
+            __m512d n = _mm512_sub_pd(t, _mm512_set1_pd(ROUND_MAGIC));
+            __m512d r = _mm512_sub_pd(x, _mm512_mul_pd(n, _mm512_set1_pd(LN2_HI)));
+            r = _mm512_sub_pd(r, _mm512_mul_pd(n, _mm512_set1_pd(LN2_LO)));
+            __m512d p = _mm512_set1_pd(C[11]);
+            for (int i = 10; i >= 0; i--) p = _mm512_add_pd(_mm512_mul_pd(p, r), _mm512_set1_pd(C[i]));
+            __m512d scale = _mm512_castsi512_pd(_mm512_slli_epi64(_mm512_sub_epi64(_mm512_castpd_si512(t), magic_bits), 52));
+            __m512d e = _mm512_mul_pd(p, scale);
+            _mm512_storeu_pd(out + j, _mm512_div_pd(one, _mm512_add_pd(one, e)));
+        }
+    }
+#endif
+};
+
+#endif
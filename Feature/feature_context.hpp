@@ -0,0 +1,165 @@
+#pragma once
+//=================================================================================================
+//                    Copyright (C) 2017 Alain Lanthier - All Rights Reserved                      
+//=================================================================================================
+//
+// FeatureContext<...> : per position data shared by all valuation features of one evaluation
+//
+// Built once per evaluated position: piece lists, king squares, own and opponent move lists,
+// move counts per piece and attack maps. The opponent move list is generated lazily (only once)
+// so features reading only the piece placement never pay for a move generation.
+//
+#ifndef _AL_CHESS_FEATURE_FEATURE_CONTEXT_HPP
+#define _AL_CHESS_FEATURE_FEATURE_CONTEXT_HPP
+
+namespace chess
+{
+    // FeatureContext
+    template <typename PieceID, typename uint8_t _BoardSize>
+    class FeatureContext
+    {
+        using _Board    = Board<PieceID, _BoardSize>;
+        using _Move     = Move<PieceID>;
+        using _Piece    = Piece<PieceID, _BoardSize>;
+
+    public:
+        FeatureContext(const _Board& position, const std::vector<_Move>& m);
+        ~FeatureContext() = default;
+
+        FeatureContext(const FeatureContext&)               = delete;
+        FeatureContext & operator=(const FeatureContext &)  = delete;
+
+        const _Board&               position()  const { return _position; }
+        PieceColor                  color()     const { return _color; }
+        const std::vector<_Move>&   moves()     const { return _moves; }
+        const std::vector<_Move>&   oppo_moves() const;
+
+        const std::vector<uint16_t>& squares(PieceID id) const  { return _piece_sq[(size_t)id]; }
+        bool        has_king(PieceColor c)  const { return _king_sq[color_index(c)] != NO_SQ; }
+        uint16_t    king_sq(PieceColor c)   const { return _king_sq[color_index(c)]; }
+
+        uint16_t    cnt_move(PieceID id) const;                     // moves of piece id (in the move list of its color)
+        uint16_t    attack(PieceColor c, uint16_t sq) const;        // moves of color c landing on sq
+        uint16_t    king_capture(PieceColor c) const;               // moves capturing the king of color c
+
+        static uint8_t x_of(uint16_t sq) { return (uint8_t)(sq % _BoardSize); }
+        static uint8_t y_of(uint16_t sq) { return (uint8_t)(sq / _BoardSize); }
+
+    private:
+        static const uint16_t NO_SQ = 0xFFFF;
+        static size_t color_index(PieceColor c) { return (c == PieceColor::W) ? 0 : 1; }
+
+        void build_move_maps(const std::vector<_Move>& mv, PieceColor c) const;
+        void ensure_maps(PieceColor c) const;
+
+        const _Board&                       _position;
+        const std::vector<_Move>&           _moves;
+        PieceColor                          _color;
+        std::vector<std::vector<uint16_t>>  _piece_sq;          // piece lists by PieceID
+        uint16_t                            _king_sq[2];
+
+        mutable std::vector<_Move>          _oppo_moves;
+        mutable bool                        _oppo_done;
+        mutable bool                        _maps_done[2];
+        mutable std::vector<uint16_t>       _cnt_move;          // by PieceID
+        mutable std::vector<uint16_t>       _attack[2];         // by square
+        mutable uint16_t                    _king_capture[2];   // moves capturing king of color
+    };
+
+    // FeatureContext() - piece lists in one board scan
+    template <typename PieceID, typename uint8_t _BoardSize>
+    FeatureContext<PieceID, _BoardSize>::FeatureContext(const _Board& position, const std::vector<_Move>& m)
+        : _position(position), _moves(m), _color(position.get_color()), _oppo_done(false)
+    {
+        _piece_sq.resize(_Piece::pieces_size());
+        _cnt_move.assign(_Piece::pieces_size(), 0);
+        for (size_t i = 0; i < 2; i++)
+        {
+            _king_sq[i] = NO_SQ;
+            _maps_done[i] = false;
+            _king_capture[i] = 0;
+            _attack[i].assign(_BoardSize * _BoardSize, 0);
+        }
+
+        const PieceID empty = _Piece::empty_id();
+        const PieceID kw = _Piece::get_id(PieceName::K, PieceColor::W);
+        const PieceID kb = _Piece::get_id(PieceName::K, PieceColor::B);
+        PieceID id;
+        for (uint8_t y = 0; y < _BoardSize; y++)
+        {
+            for (uint8_t x = 0; x < _BoardSize; x++)
+            {
+                id = position.get_pieceid_at(x, y);
+                if (id == empty) continue;
+                uint16_t sq = (uint16_t)(x + y * _BoardSize);
+                _piece_sq[(size_t)id].push_back(sq);
+                if      (id == kw) _king_sq[0] = sq;
+                else if (id == kb) _king_sq[1] = sq;
+            }
+        }
+    }
+
+    // oppo_moves() - generated once on a board copy with the opposite color to play
+    template <typename PieceID, typename uint8_t _BoardSize>
+    inline const std::vector<Move<PieceID>>& FeatureContext<PieceID, _BoardSize>::oppo_moves() const
+    {
+        if (!_oppo_done)
+        {
+            _Board b = _position;
+            b.set_opposite_color();
+            _oppo_moves = b.generate_moves();
+            _oppo_done = true;
+        }
+        return _oppo_moves;
+    }
+
+    // build_move_maps() - move count per piece, attack map and king captures of color c
+    template <typename PieceID, typename uint8_t _BoardSize>
+    inline void FeatureContext<PieceID, _BoardSize>::build_move_maps(const std::vector<_Move>& mv, PieceColor c) const
+    {
+        const PieceID k_oppo = _Piece::get_id(PieceName::K, (c == PieceColor::W) ? PieceColor::B : PieceColor::W);
+        size_t ci = color_index(c);
+        size_t oi = 1 - ci;
+        for (const auto& v : mv)
+        {
+            _cnt_move[(size_t)v.prev_src_id]++;
+            _attack[ci][v.dst_x + v.dst_y * _BoardSize]++;
+            if (v.prev_dst_id == k_oppo) _king_capture[oi]++;
+        }
+        _maps_done[ci] = true;
+    }
+
+    template <typename PieceID, typename uint8_t _BoardSize>
+    inline void FeatureContext<PieceID, _BoardSize>::ensure_maps(PieceColor c) const
+    {
+        if (_maps_done[color_index(c)]) return;
+        if (c == _color) build_move_maps(_moves, c);
+        else             build_move_maps(oppo_moves(), c);
+    }
+
+    // cnt_move()
+    template <typename PieceID, typename uint8_t _BoardSize>
+    inline uint16_t FeatureContext<PieceID, _BoardSize>::cnt_move(PieceID id) const
+    {
+        ensure_maps(_Piece::get(id)->get_color());
+        return _cnt_move[(size_t)id];
+    }
+
+    // attack()
+    template <typename PieceID, typename uint8_t _BoardSize>
+    inline uint16_t FeatureContext<PieceID, _BoardSize>::attack(PieceColor c, uint16_t sq) const
+    {
+        ensure_maps(c);
+        return _attack[color_index(c)][sq];
+    }
+
+    // king_capture() - moves of the other color capturing the king of color c
+    template <typename PieceID, typename uint8_t _BoardSize>
+    inline uint16_t FeatureContext<PieceID, _BoardSize>::king_capture(PieceColor c) const
+    {
+        ensure_maps((c == PieceColor::W) ? PieceColor::B : PieceColor::W);
+        return _king_capture[color_index(c)];
+    }
+};
+
+#endif
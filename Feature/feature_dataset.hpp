@@ -0,0 +1,296 @@
+#pragma once
+//=================================================================================================
+//                    Copyright (C) 2017 Alain Lanthier - All Rights Reserved                      
+//=================================================================================================
+//
+// FeatureDataset        : labelled valuation feature rows (row major, contiguous) of domain positions
+// FeatureDatasetBuilder : parallel sharded builder of a FeatureDataset
+//
+// The domain index range is split in shards, shards are computed concurrently (features + TB label)
+// into their own preallocated buffer and appended in shard order, so the dataset is the same as a
+// single thread walk of the domain in index order.
+// With a store file (set_store_file()), the rows are the samples of a SelfPlayStore instead (positions reached
+// in self-play games, labelled by the pipeline), computed the same way in shards of the store order.
+//
+#ifndef _AL_CHESS_FEATURE_FEATURE_DATASET_HPP
+#define _AL_CHESS_FEATURE_FEATURE_DATASET_HPP
+
+namespace chess
+{
+    // FeatureDataset
+    struct FeatureDataset
+    {
+        size_t              _nfeature = 0;
+        std::vector<double> _x;                 // size() rows of _nfeature values
+        std::vector<double> _y;                 // label of the position TB score: WIN +1, DRAW 0, LOSS -1
+
+        size_t          size() const            { return _y.size(); }
+        const double*   row(size_t i) const     { return _x.data() + i * _nfeature; }
+        void clear(size_t nfeature = 0)         { _nfeature = nfeature; _x.clear(); _y.clear(); }
+
+        void reserve(size_t n)
+        {
+            _x.reserve(n * _nfeature);
+            _y.reserve(n);
+        }
+
+        // append() - rows [0, n) of d
+        void append(const FeatureDataset& d, size_t n)
+        {
+            assert(d._nfeature == _nfeature);
+            n = std::min<size_t>(n, d.size());
+            _x.insert(_x.end(), d._x.begin(), d._x.begin() + n * _nfeature);
+            _y.insert(_y.end(), d._y.begin(), d._y.begin() + n);
+        }
+
+        static double score_label(ExactScore sc)
+        {
+            if (sc == ExactScore::WIN)  return +1.0;
+            if (sc == ExactScore::LOSS) return -1.0;
+            return 0.0;
+        }
+    };
+
+    // FeatureDatasetBuilder
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    class FeatureDatasetBuilder
+    {
+        using _Board    = Board<PieceID, _BoardSize>;
+        using _Move     = Move<PieceID>;
+        using _ValuationFeature = ValuationFeature<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _ConditionValuationNode = ConditionValuationNode<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _DomainPlayer     = DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _Domain           = Domain<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _FeatureMatrixCache = FeatureMatrixCache<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _Sample           = SelfPlaySample<PieceID, _BoardSize>;
+        using _ShardBuilder     = std::function<void(uint64_t begin, uint64_t end, size_t max_samples, FeatureDataset* ret_dataset)>;
+
+    public:
+        // build() - first max_samples positions (index order) of the player domain reaching node and having a known score
+        //           (reused from/saved to FeatureMatrixCache when enabled), or build_from_store() when a store file is set
+        static bool build(_DomainPlayer& player, _ConditionValuationNode* node, const std::vector<_ValuationFeature*>& valuations,
+                          size_t max_samples, FeatureDataset& ret_dataset);
+
+        // build_from_store() - first max_samples samples (store order) of a SelfPlayStore file in the player domain,
+        //                      color to play of the player, reaching node and having a known score
+        static bool build_from_store(_DomainPlayer& player, _ConditionValuationNode* node, const std::vector<_ValuationFeature*>& valuations,
+                                     const std::string& store_file, size_t max_samples, FeatureDataset& ret_dataset);
+
+        static const std::string& store_file()              { return _store_file; }
+        static void     set_store_file(const std::string& f) { _store_file = f; }   // "": walk of the domain
+
+        static size_t   num_shard_per_thread()              { return _num_shard_per_thread; }
+        static void     set_num_shard_per_thread(size_t n)  { _num_shard_per_thread = std::max<size_t>(1, n); }
+        static bool     parallel()                          { return _parallel; }
+        static void     set_parallel(bool v)                { _parallel = v; }
+
+    protected:
+        static size_t   _num_shard_per_thread;      // more shards than threads: less work past max_samples and better balance
+        static bool     _parallel;
+        static std::string _store_file;
+
+        static void build_waves(uint64_t count, size_t max_samples, const _ShardBuilder& shard_builder, FeatureDataset& ret_dataset);
+        static void build_shard(const _Domain* domain, PieceColor c, const std::vector<_ConditionValuationNode*>& v_path,
+                                const std::vector<_ValuationFeature*>& valuations, uint64_t begin, uint64_t end, size_t max_samples, FeatureDataset* ret_dataset);
+        static void build_store_shard(const _Domain* domain, PieceColor c, const std::vector<_ConditionValuationNode*>& v_path,
+                                      const std::vector<_ValuationFeature*>& valuations, const std::vector<_Sample>& samples,
+                                      uint64_t begin, uint64_t end, size_t max_samples, FeatureDataset* ret_dataset);
+        static std::vector<_ConditionValuationNode*> node_path(_ConditionValuationNode* node);
+        static bool is_in_node(const _Board& b, const std::vector<_Move>& m, const std::vector<_ConditionValuationNode*>& v_path);
+    };
+
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    size_t FeatureDatasetBuilder<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::_num_shard_per_thread = 8;
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    bool FeatureDatasetBuilder<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::_parallel = true;
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    std::string FeatureDatasetBuilder<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::_store_file = "";
+
+    // build()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    bool FeatureDatasetBuilder<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::
+    build(_DomainPlayer& player, _ConditionValuationNode* node, const std::vector<_ValuationFeature*>& valuations, size_t max_samples, FeatureDataset& ret_dataset)
+    {
+        if (!_store_file.empty())
+            return build_from_store(player, node, valuations, _store_file, max_samples, ret_dataset);
+
+        ret_dataset.clear(valuations.size());
+
+        const _Domain* domain = player.domain();
+        if (domain == nullptr) return false;
+        PieceColor c = player.color_player();
+        uint64_t count = domain->position_count(c);
+        if (count == 0) return false;
+
+        std::vector<_ConditionValuationNode*> v_path = node_path(node);
+
+        std::string cache_key;
+        if (_FeatureMatrixCache::enabled())
+        {
+            cache_key = _FeatureMatrixCache::make_key(player, v_path, valuations);
+            if (_FeatureMatrixCache::load(cache_key, max_samples, ret_dataset))
+                return true;
+        }
+
+        build_waves(count, max_samples, [&](uint64_t begin, uint64_t end, size_t need, FeatureDataset* shard)
+        {
+            build_shard(domain, c, v_path, valuations, begin, end, need, shard);
+        }, ret_dataset);
+
+        if (_FeatureMatrixCache::enabled())
+        {
+            // cache stores float: same values on the first run as on the cached runs
+            for (auto& v : ret_dataset._x) v = (double)(float)v;
+            _FeatureMatrixCache::save(cache_key, max_samples, ret_dataset);
+        }
+        return true;
+    }
+
+    // build_from_store()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    bool FeatureDatasetBuilder<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::
+    build_from_store(_DomainPlayer& player, _ConditionValuationNode* node, const std::vector<_ValuationFeature*>& valuations,
+                     const std::string& store_file, size_t max_samples, FeatureDataset& ret_dataset)
+    {
+        ret_dataset.clear(valuations.size());
+
+        const _Domain* domain = player.domain();
+        if (domain == nullptr) return false;
+        PieceColor c = player.color_player();
+
+        std::vector<_Sample> samples;
+        if (!SelfPlayStore<PieceID, _BoardSize>::read(store_file, samples)) return false;
+        if (samples.empty()) return true;
+
+        std::vector<_ConditionValuationNode*> v_path = node_path(node);
+
+        build_waves(samples.size(), max_samples, [&](uint64_t begin, uint64_t end, size_t need, FeatureDataset* shard)
+        {
+            build_store_shard(domain, c, v_path, valuations, samples, begin, end, need, shard);
+        }, ret_dataset);
+        return true;
+    }
+
+    // build_waves() - [0, count) split in shards, waves of concurrency shards merged in shard order until max_samples
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    void FeatureDatasetBuilder<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::
+    build_waves(uint64_t count, size_t max_samples, const _ShardBuilder& shard_builder, FeatureDataset& ret_dataset)
+    {
+        unsigned concurrency = _parallel ? thread_concurrency() : 1;
+        uint64_t nshard = std::min<uint64_t>(count, (uint64_t)concurrency * _num_shard_per_thread);
+        uint64_t shard_size = (count + nshard - 1) / nshard;
+        nshard = (count + shard_size - 1) / shard_size;
+
+        std::vector<FeatureDataset> shards(concurrency);
+        for (uint64_t first = 0; (first < nshard) && (ret_dataset.size() < max_samples); first += concurrency)
+        {
+            size_t nwave = (size_t)std::min<uint64_t>(concurrency, nshard - first);
+            size_t need = max_samples - ret_dataset.size();    // no shard of this wave needs more
+
+            if (nwave == 1)
+            {
+                shard_builder(first * shard_size, std::min<uint64_t>(count, (first + 1) * shard_size), need, &shards[0]);
+            }
+            else
+            {
+                std::vector<std::future<void>> fut;
+                for (size_t i = 0; i < nwave; i++)
+                {
+                    uint64_t begin = (first + i) * shard_size;
+                    uint64_t end = std::min<uint64_t>(count, begin + shard_size);
+                    fut.push_back(std::async(std::launch::async, [&, begin, end, need, i]() { shard_builder(begin, end, need, &shards[i]); }));
+                }
+                for (auto& f : fut) f.get();
+            }
+
+            for (size_t i = 0; (i < nwave) && (ret_dataset.size() < max_samples); i++)
+                ret_dataset.append(shards[i], max_samples - ret_dataset.size());
+        }
+    }
+
+    // build_shard() - positions of [begin, end) in index order, own board and cursor
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    void FeatureDatasetBuilder<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::
+    build_shard(const _Domain* domain, PieceColor c, const std::vector<_ConditionValuationNode*>& v_path,
+                const std::vector<_ValuationFeature*>& valuations, uint64_t begin, uint64_t end, size_t max_samples, FeatureDataset* ret_dataset)
+    {
+        ret_dataset->clear(valuations.size());
+        ret_dataset->reserve((size_t)std::min<uint64_t>(max_samples, end - begin));
+
+        _Board b;
+        std::vector<_Move> m;
+        std::vector<TYPE_PARAM> values;
+        size_t ret_mv_idx;
+        ExactScore sc;
+
+        for (uint64_t index = begin; (ret_dataset->size() < max_samples) && domain->position_at(c, index, end, b); index++)
+        {
+            if (!domain->isInDomain(b)) continue;
+            m = b.generate_moves();
+            if (!is_in_node(b, m, v_path)) continue;
+
+            sc = domain->get_known_score_move(b, m, ret_mv_idx); // TB read
+            if (sc == ExactScore::UNKNOWN) continue;
+
+            _ValuationFeature::compute_all(b, m, valuations, values);
+            for (size_t i = 0; i < values.size(); i++) ret_dataset->_x.push_back((double)values[i]);
+            ret_dataset->_y.push_back(FeatureDataset::score_label(sc));
+        }
+    }
+
+    // build_store_shard() - samples [begin, end) in store order, own board
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    void FeatureDatasetBuilder<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::
+    build_store_shard(const _Domain* domain, PieceColor c, const std::vector<_ConditionValuationNode*>& v_path,
+                      const std::vector<_ValuationFeature*>& valuations, const std::vector<_Sample>& samples,
+                      uint64_t begin, uint64_t end, size_t max_samples, FeatureDataset* ret_dataset)
+    {
+        ret_dataset->clear(valuations.size());
+        ret_dataset->reserve((size_t)std::min<uint64_t>(max_samples, end - begin));
+
+        _Board b;
+        std::vector<_Move> m;
+        std::vector<TYPE_PARAM> values;
+
+        for (uint64_t index = begin; (ret_dataset->size() < max_samples) && (index < end); index++)
+        {
+            const _Sample& s = samples[(size_t)index];
+            if ((s._color != c) || (s._tb_score == ExactScore::UNKNOWN)) continue;   // labelled by the pipeline
+
+            s.to_board(b);
+            if (!domain->isInDomain(b)) continue;
+            m = b.generate_moves();
+            if (!is_in_node(b, m, v_path)) continue;
+
+            _ValuationFeature::compute_all(b, m, valuations, values);
+            for (size_t i = 0; i < values.size(); i++) ret_dataset->_x.push_back((double)values[i]);
+            ret_dataset->_y.push_back(FeatureDataset::score_label(s._tb_score));
+        }
+    }
+
+    // node_path() - path from the root child down to node (root condition is always true)
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    std::vector<ConditionValuationNode<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>*> FeatureDatasetBuilder<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::
+    node_path(_ConditionValuationNode* node)
+    {
+        std::vector<_ConditionValuationNode*> v_path = node->get_path();   // in reverse order
+        if (!v_path.empty()) v_path.pop_back();
+        std::reverse(v_path.begin(), v_path.end());
+        return v_path;
+    }
+
+    // is_in_node() - does position match node path Fcond[] implicit sub_domain
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    bool FeatureDatasetBuilder<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::
+    is_in_node(const _Board& b, const std::vector<_Move>& m, const std::vector<_ConditionValuationNode*>& v_path)
+    {
+        for (size_t i = 0; i < v_path.size(); i++)
+        {
+            // negative node get_condition_value() is already the reverse of its mirror condition
+            if (!v_path[i]->get_condition_value(b, m)) return false;
+        }
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,285 @@
+#pragma once
+//=================================================================================================
+//                    Copyright (C) 2017 Alain Lanthier - All Rights Reserved                      
+//=================================================================================================
+//
+// FeatureMatrixCache : on disk cache of FeatureDataset (binary, memory mapped on load)
+//
+// A dataset only depends on the domain, the player color, the valuation features and the node path
+// conditions. That is the cache key: it is written in full in the file header and compared on load,
+// any mismatch (or a different _BoardSize/format) rebuilds the file. The builder returns the first
+// rows in domain index order, so a file built for n samples also serves any request <= n.
+//
+// File layout:
+//      FileHeader | key (_key_size bytes) | padding to 8 | float rows[_count * _nfeature] | float labels[_count]
+//
+#ifndef _AL_CHESS_FEATURE_FEATURE_MATRIX_CACHE_HPP
+#define _AL_CHESS_FEATURE_FEATURE_MATRIX_CACHE_HPP
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace chess
+{
+    // MappedFile - read only memory mapping of a whole file
+    class MappedFile
+    {
+    public:
+        MappedFile() {}
+        ~MappedFile() { close(); }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile & operator=(const MappedFile &) = delete;
+
+        bool open(const std::string& filename)
+        {
+            close();
+#ifdef _WIN32
+            _file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+            if (_file == INVALID_HANDLE_VALUE) return false;
+            LARGE_INTEGER sz;
+            if (!GetFileSizeEx(_file, &sz) || (sz.QuadPart == 0)) { close(); return false; }
+            _size = (size_t)sz.QuadPart;
+            _mapping = CreateFileMappingA(_file, NULL, PAGE_READONLY, 0, 0, NULL);
+            if (_mapping == NULL) { close(); return false; }
+            _data = (const char*)MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+            if (_data == nullptr) { close(); return false; }
+#else
+            _fd = ::open(filename.c_str(), O_RDONLY);
+            if (_fd < 0) return false;
+            struct stat st;
+            if ((fstat(_fd, &st) != 0) || (st.st_size == 0)) { close(); return false; }
+            _size = (size_t)st.st_size;
+            void* p = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fd, 0);
+            if (p == MAP_FAILED) { close(); return false; }
+            _data = (const char*)p;
+#endif
+            return true;
+        }
+
+        void close()
+        {
+#ifdef _WIN32
+            if (_data != nullptr)                   UnmapViewOfFile(_data);
+            if (_mapping != NULL)                   CloseHandle(_mapping);
+            if (_file != INVALID_HANDLE_VALUE)      CloseHandle(_file);
+            _mapping = NULL;
+            _file = INVALID_HANDLE_VALUE;
+#else
+            if (_data != nullptr)   munmap((void*)_data, _size);
+            if (_fd >= 0)           ::close(_fd);
+            _fd = -1;
+#endif
+            _data = nullptr;
+            _size = 0;
+        }
+
+        const char* data() const { return _data; }
+        size_t      size() const { return _size; }
+
+    private:
+        const char* _data = nullptr;
+        size_t      _size = 0;
+#ifdef _WIN32
+        HANDLE      _file = INVALID_HANDLE_VALUE;
+        HANDLE      _mapping = NULL;
+#else
+        int         _fd = -1;
+#endif
+    };
+
+    // FeatureMatrixCache
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    class FeatureMatrixCache
+    {
+        using _ValuationFeature = ValuationFeature<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _ConditionFeature = ConditionFeature<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _ConditionValuationNode = ConditionValuationNode<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _FeatureCondAlgo  = FeatureCondAlgo<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _FeatureCondAlgo_cond_product_boolean = FeatureCondAlgo_cond_product_boolean<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _DomainPlayer     = DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+
+        static const uint32_t VERSION = 1;
+
+        struct FileHeader
+        {
+            char        _magic[4];      // "ALFM"
+            uint32_t    _version;
+            uint32_t    _board_size;
+            uint32_t    _nfeature;
+            uint64_t    _count;         // rows in file
+            uint64_t    _requested;     // max_samples of the build (_count < _requested: domain exhausted)
+            uint32_t    _key_size;
+            uint32_t    _reserved;
+        };
+
+    public:
+        static bool enabled()               { return _enabled; }
+        static void set_enabled(bool v)     { _enabled = v; }
+
+        // make_key() - domain, color, feature ids and node path conditions
+        static std::string make_key(_DomainPlayer& player, const std::vector<_ConditionValuationNode*>& v_path, const std::vector<_ValuationFeature*>& valuations);
+
+        // load() - first max_samples rows of the cache file of key, false if no valid file
+        static bool load(const std::string& key, size_t max_samples, FeatureDataset& ret_dataset);
+
+        // save() - dataset built for max_samples
+        static bool save(const std::string& key, size_t max_samples, const FeatureDataset& dataset);
+
+        static std::string file_name(const std::string& key)
+        {
+            std::stringstream ss;
+            ss << std::hex << hash_string64(key);
+            return PersistManager<PieceID, _BoardSize>::instance()->get_stream_name("featurecache", ss.str());
+        }
+
+    protected:
+        static bool _enabled;
+
+        static size_t data_offset(size_t key_size) { return (sizeof(FileHeader) + key_size + 7) & ~(size_t)7; }
+
+        static std::string temp_file_name(const std::string& f)
+        {
+            std::stringstream ss;
+#ifdef _WIN32
+            ss << f << ".tmp." << GetCurrentProcessId();
+#else
+            ss << f << ".tmp." << getpid();
+#endif
+            ss << "." << std::hex << std::hash<std::thread::id>()(std::this_thread::get_id());
+            return ss.str();
+        }
+    };
+
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    bool FeatureMatrixCache<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::_enabled = true;
+
+    // make_key()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    std::string FeatureMatrixCache<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::
+    make_key(_DomainPlayer& player, const std::vector<_ConditionValuationNode*>& v_path, const std::vector<_ValuationFeature*>& valuations)
+    {
+        std::stringstream ss;
+        ss << "domain=" << player.domain()->partition_key() << "/" << player.domain()->domain_key();
+        ss << ";color=" << PieceColor_to_int(player.color_player());
+        ss << ";valu=";
+        for (auto& f : valuations) ss << f->classtype() << "(" << f->classtype_arg() << ")";
+        ss << ";path=";
+        for (auto& node : v_path)
+        {
+            const _FeatureCondAlgo* algo = node->active_cond_algo();
+            ss << (node->is_positive_node() ? "+" : "-");
+            if (algo == nullptr) { ss << "null|"; continue; }
+            if (algo->cfg()._name == FeatureBasedAlgoName::cond_product_boolean)
+            {
+                const _FeatureCondAlgo_cond_product_boolean* a = (const _FeatureCondAlgo_cond_product_boolean*)algo;
+                for (size_t i = 0; i < a->conditions().size(); i++)
+                {
+                    if (i > 0) ss << (a->conditions_and_or()[i] ? "&" : "|");
+                    ss << a->conditions()[i]->classtype() << "(" << a->conditions()[i]->classtype_arg() << ")";
+                }
+            }
+            else
+            {
+                // trained condition algo: identified by its persisted instance
+                ss << FeatureBasedAlgoName_to_string(algo->cfg()._name) << "#" << algo->cfg()._persist_key;
+            }
+            ss << "|";
+        }
+        return ss.str();
+    }
+
+    // load()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    bool FeatureMatrixCache<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::
+    load(const std::string& key, size_t max_samples, FeatureDataset& ret_dataset)
+    {
+        MappedFile mf;
+        if (!mf.open(file_name(key))) return false;
+        if (mf.size() < sizeof(FileHeader)) return false;
+
+        FileHeader h;
+        std::memcpy(&h, mf.data(), sizeof(FileHeader));
+        if (std::memcmp(h._magic, "ALFM", 4) != 0)  return false;
+        if (h._version != VERSION)                  return false;
+        if (h._board_size != (uint32_t)_BoardSize)  return false;
+        if (mf.size() < sizeof(FileHeader) + h._key_size) return false;
+        if (key.compare(0, std::string::npos, mf.data() + sizeof(FileHeader), h._key_size) != 0) return false;
+
+        // enough rows: built for at least max_samples, or the domain had no more
+        if ((h._requested < max_samples) && (h._count >= h._requested)) return false;
+
+        size_t offset = data_offset(h._key_size);
+        size_t expected = offset + (size_t)(h._count * h._nfeature + h._count) * sizeof(float);
+        if (mf.size() != expected) return false;
+
+        size_t n = (size_t)std::min<uint64_t>(h._count, max_samples);
+        const float* x = (const float*)(mf.data() + offset);
+        const float* y = x + h._count * h._nfeature;
+
+        ret_dataset.clear(h._nfeature);
+        ret_dataset._x.assign(x, x + n * h._nfeature);
+        ret_dataset._y.assign(y, y + n);
+        return true;
+    }
+
+    // save()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    bool FeatureMatrixCache<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::
+    save(const std::string& key, size_t max_samples, const FeatureDataset& dataset)
+    {
+        FileHeader h;
+        std::memcpy(h._magic, "ALFM", 4);
+        h._version = VERSION;
+        h._board_size = (uint32_t)_BoardSize;
+        h._nfeature = (uint32_t)dataset._nfeature;
+        h._count = dataset.size();
+        h._requested = max_samples;
+        h._key_size = (uint32_t)key.size();
+        h._reserved = 0;
+
+        // write aside then replace, a concurrent reader never sees a partial file
+        // (temp file unique per process and thread: concurrent writers of the same key never share it)
+        std::string f = file_name(key);
+        std::string ftmp = temp_file_name(f);
+        {
+            std::ofstream os;
+            os.open(ftmp.c_str(), std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+            if (!os.good()) return false;
+
+            os.write((const char*)&h, sizeof(FileHeader));
+            os.write(key.data(), key.size());
+            size_t pad = data_offset(key.size()) - sizeof(FileHeader) - key.size();
+            const char zero[8] = { 0 };
+            os.write(zero, pad);
+
+            std::vector<float> buffer(dataset._x.begin(), dataset._x.end());
+            os.write((const char*)buffer.data(), buffer.size() * sizeof(float));
+            buffer.assign(dataset._y.begin(), dataset._y.end());
+            os.write((const char*)buffer.data(), buffer.size() * sizeof(float));
+
+            bool ok = !os.bad();
+            os.close();
+            if (!ok)
+            {
+                std::remove(ftmp.c_str());
+                return false;
+            }
+        }
+
+        // replace in one step: on failure (Ex: file mapped by a reader) the current cache file is kept, not fatal
+#ifdef _WIN32
+        bool replaced = (MoveFileExA(ftmp.c_str(), f.c_str(), MOVEFILE_REPLACE_EXISTING) != 0);
+#else
+        bool replaced = (std::rename(ftmp.c_str(), f.c_str()) == 0);
+#endif
+        if (!replaced) std::remove(ftmp.c_str());
+        return replaced;
+    }
+};
+
+#endif
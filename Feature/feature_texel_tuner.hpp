@@ -0,0 +1,322 @@
+#pragma once
+//=================================================================================================
+//                    Copyright (C) 2017 Alain Lanthier - All Rights Reserved                      
+//=================================================================================================
+//
+// TexelTuner        : logistic regression of weight_sum weights on TB labelled positions
+// FeatureTexelTuner : tune a FeatureValuAlgo_weight_sum from the labelled positions of its node
+//
+// weight_sum evaluates p = sigmoid(a * w.x) (white winning = 1). The TB outcome of a position gives
+// the target t (WIN 1, DRAW 0.5, LOSS 0) and the weights minimize the mean log loss
+//      L(w) = mean[ log(1 + exp(s)) - t*s ] + l2/2 |w|^2,     s = a * w.x,     dL/dw = mean[ a * (p - t) * x ] + l2 * w
+// with minibatch Adam or full batch L-BFGS (dlib). Loss and gradient are summed over row shards computed
+// concurrently and merged in shard order (reproducible for a given number of threads).
+// With a weight bound (Ex: the GA +/-WEIGHT_BOUND) the weights stay in the box: Adam steps are clamped, L-BFGS is
+// box constrained.
+//
+#ifndef _AL_CHESS_FEATURE_FEATURE_TEXEL_TUNER_HPP
+#define _AL_CHESS_FEATURE_FEATURE_TEXEL_TUNER_HPP
+
+#include <ExternLib/dlib/optimization.h>
+
+namespace chess
+{
+    enum class TexelOptimizer { adam, lbfgs };
+
+    struct TexelTunerResult
+    {
+        size_t  _nsample = 0;
+        size_t  _iterations = 0;    // epochs (adam) or objective evaluations (lbfgs)
+        double  _loss_start = 0;    // full dataset loss
+        double  _loss_end = 0;
+    };
+
+    // TexelTunerOptions
+    struct TexelTunerOptions
+    {
+        TexelOptimizer  _optimizer = TexelOptimizer::adam;
+        size_t          _epochs = 50;                   // adam epochs / lbfgs max iterations
+        size_t          _batch_size = 1024;             // adam minibatch rows (0 = full batch)
+        double          _learning_rate = 1.0;           // adam step, in weight units
+        double          _l2 = 0.0;
+        double          _scale = SIGMOID_SCALE;         // a of sigmoid(a * w.x), as weight_sum
+        double          _weight_bound = 0.0;            // |w| <= bound (0 = none)
+        uint64_t        _seed = 1;                      // minibatch shuffle stream (under the RngMaster seed)
+        bool            _parallel = true;
+        size_t          _min_rows_per_thread = 2048;    // smaller batches are not split
+    };
+
+    // TexelTuner
+    class TexelTuner
+    {
+    public:
+        static TexelOptimizer   optimizer()                     { return options()._optimizer; }
+        static double           weight_bound()                  { return options()._weight_bound; }
+        static void             set_optimizer(TexelOptimizer v) { options()._optimizer = v; }
+        static void             set_epochs(size_t n)            { options()._epochs = std::max<size_t>(1, n); }
+        static void             set_batch_size(size_t n)        { options()._batch_size = n; }
+        static void             set_learning_rate(double v)     { options()._learning_rate = v; }
+        static void             set_l2(double v)                { options()._l2 = v; }
+        static void             set_scale(double v)             { options()._scale = v; }
+        static void             set_weight_bound(double v)      { options()._weight_bound = std::abs(v); }
+        static void             set_seed(uint64_t v)            { options()._seed = v; }
+        static void             set_parallel(bool v)            { options()._parallel = v; }
+        static void             set_min_rows_per_thread(size_t n) { options()._min_rows_per_thread = std::max<size_t>(1, n); }
+
+        static double target(double label) { return 0.5 * (label + 1.0); }   // WIN +1 -> 1, DRAW 0 -> 0.5, LOSS -1 -> 0
+
+        // tune() - w (size ds._nfeature, start point) minimizing the log loss on ds, |w| <= weight_bound (0 = none)
+        static bool tune(const FeatureDataset& ds, std::vector<double>& w, double weight_bound, char verbose, TexelTunerResult* ret_result = nullptr);
+
+        // loss() - mean loss on rows idx[0..n) (idx == nullptr: rows 0..n-1), mean gradient in ret_grad if not null
+        static double loss(const FeatureDataset& ds, const size_t* idx, size_t n, const std::vector<double>& w, std::vector<double>* ret_grad);
+
+    protected:
+        // options() - one instance in the program (header only, no out of class static definition)
+        static TexelTunerOptions& options()
+        {
+            static TexelTunerOptions opt;
+            return opt;
+        }
+
+        static bool tune_adam(const FeatureDataset& ds, std::vector<double>& w, double weight_bound, char verbose, TexelTunerResult& r);
+        static bool tune_lbfgs(const FeatureDataset& ds, std::vector<double>& w, double weight_bound, char verbose, TexelTunerResult& r);
+        static double loss_shard(const FeatureDataset& ds, const size_t* idx, size_t begin, size_t end, const std::vector<double>& w, std::vector<double>* ret_grad);
+
+        static double softplus(double s) { return (s > 0) ? s + std::log1p(std::exp(-s)) : std::log1p(std::exp(s)); }
+        static void   clamp(std::vector<double>& w, double weight_bound)
+        {
+            if (weight_bound <= 0) return;
+            for (auto& v : w) v = std::max<double>(-weight_bound, std::min<double>(weight_bound, v));
+        }
+    };
+
+    // tune()
+    inline bool TexelTuner::tune(const FeatureDataset& ds, std::vector<double>& w, double weight_bound, char verbose, TexelTunerResult* ret_result)
+    {
+        TexelTunerResult r;
+        if ((ds.size() == 0) || (ds._nfeature == 0)) return false;
+        w.resize(ds._nfeature, 0.0);
+        clamp(w, weight_bound);                                 // start point in the box
+
+        r._nsample = ds.size();
+        r._loss_start = loss(ds, nullptr, ds.size(), w, nullptr);
+        bool ok = (options()._optimizer == TexelOptimizer::lbfgs) ? tune_lbfgs(ds, w, weight_bound, verbose, r) : tune_adam(ds, w, weight_bound, verbose, r);
+        r._loss_end = loss(ds, nullptr, ds.size(), w, nullptr);
+        if (verbose) std::cout << "texel tuner: " << r._nsample << " samples, loss " << r._loss_start << " -> " << r._loss_end << " (" << r._iterations << ")" << std::endl;
+
+        if (ret_result != nullptr) *ret_result = r;
+        return ok;
+    }
+
+    // loss()
+    inline double TexelTuner::loss(const FeatureDataset& ds, const size_t* idx, size_t n, const std::vector<double>& w, std::vector<double>* ret_grad)
+    {
+        size_t nf = ds._nfeature;
+        double sum;
+        size_t nshard = 1;
+        if (options()._parallel)
+        {
+            unsigned concurrency = std::thread::hardware_concurrency();
+            if (concurrency < 1) concurrency = 1;
+            nshard = std::min<size_t>(concurrency, n / options()._min_rows_per_thread);
+            if (nshard < 1) nshard = 1;
+        }
+
+        if (nshard == 1)
+        {
+            if (ret_grad != nullptr) ret_grad->assign(nf, 0.0);
+            sum = loss_shard(ds, idx, 0, n, w, ret_grad);
+        }
+        else
+        {
+            size_t shard_size = (n + nshard - 1) / nshard;
+            std::vector<double> shard_sum(nshard, 0.0);
+            std::vector<std::vector<double>> shard_grad(nshard);
+            std::vector<std::future<void>> fut;
+            for (size_t k = 0; k < nshard; k++)
+            {
+                fut.push_back(std::async(std::launch::async, [&, k]()
+                {
+                    std::vector<double>* g = nullptr;
+                    if (ret_grad != nullptr) { shard_grad[k].assign(nf, 0.0); g = &shard_grad[k]; }
+                    shard_sum[k] = loss_shard(ds, idx, k * shard_size, std::min<size_t>(n, (k + 1) * shard_size), w, g);
+                }));
+            }
+            for (auto& f : fut) f.get();
+
+            // merged in shard order: deterministic for a given number of shards
+            sum = 0;
+            if (ret_grad != nullptr) ret_grad->assign(nf, 0.0);
+            for (size_t k = 0; k < nshard; k++)
+            {
+                sum += shard_sum[k];
+                if (ret_grad != nullptr)
+                    for (size_t i = 0; i < nf; i++) (*ret_grad)[i] += shard_grad[k][i];
+            }
+        }
+
+        double l2 = options()._l2;
+        double inv_n = (n > 0) ? 1.0 / (double)n : 0.0;
+        double l = sum * inv_n;
+        for (size_t i = 0; i < nf; i++) l += 0.5 * l2 * w[i] * w[i];
+        if (ret_grad != nullptr)
+        {
+            for (size_t i = 0; i < nf; i++) (*ret_grad)[i] = (*ret_grad)[i] * inv_n + l2 * w[i];
+        }
+        return l;
+    }
+
+    // loss_shard() - sums (not means) over rows [begin, end) of the index list
+    inline double TexelTuner::loss_shard(const FeatureDataset& ds, const size_t* idx, size_t begin, size_t end, const std::vector<double>& w, std::vector<double>* ret_grad)
+    {
+        size_t nf = ds._nfeature;
+        double scale = options()._scale;
+        double sum = 0;
+        for (size_t j = begin; j < end; j++)
+        {
+            const double* x = ds.row((idx != nullptr) ? idx[j] : j);
+            double t = target(ds._y[(idx != nullptr) ? idx[j] : j]);
+            double z = 0;
+            for (size_t i = 0; i < nf; i++) z += w[i] * x[i];
+            double s = scale * z;
+            sum += softplus(s) - t * s;
+            if (ret_grad != nullptr)
+            {
+                double d = scale * (1.0 / (1.0 + std::exp(-s)) - t);
+                for (size_t i = 0; i < nf; i++) (*ret_grad)[i] += d * x[i];
+            }
+        }
+        return sum;
+    }
+
+    // tune_adam() - shuffled minibatches each epoch, projected back in the box after each step
+    inline bool TexelTuner::tune_adam(const FeatureDataset& ds, std::vector<double>& w, double weight_bound, char verbose, TexelTunerResult& r)
+    {
+        const TexelTunerOptions& opt = options();
+        const double beta1 = 0.9;
+        const double beta2 = 0.999;
+        const double eps = 1e-8;
+        size_t nf = ds._nfeature;
+        size_t n = ds.size();
+        size_t batch = ((opt._batch_size == 0) || (opt._batch_size > n)) ? n : opt._batch_size;
+
+        std::vector<size_t> order(n);
+        for (size_t j = 0; j < n; j++) order[j] = j;
+        CounterRng gen = RngMaster::stream(RngStreamId::texel).stream(opt._seed);
+
+        std::vector<double> m(nf, 0.0), v(nf, 0.0), g;
+        double beta1_t = 1.0, beta2_t = 1.0;
+        for (size_t epoch = 0; epoch < opt._epochs; epoch++)
+        {
+            std::shuffle(order.begin(), order.end(), gen);
+            for (size_t first = 0; first < n; first += batch)
+            {
+                loss(ds, order.data() + first, std::min<size_t>(batch, n - first), w, &g);
+                beta1_t *= beta1;
+                beta2_t *= beta2;
+                for (size_t i = 0; i < nf; i++)
+                {
+                    m[i] = beta1 * m[i] + (1 - beta1) * g[i];
+                    v[i] = beta2 * v[i] + (1 - beta2) * g[i] * g[i];
+                    w[i] -= opt._learning_rate * (m[i] / (1 - beta1_t)) / (std::sqrt(v[i] / (1 - beta2_t)) + eps);
+                }
+                clamp(w, weight_bound);
+            }
+            r._iterations++;
+            if (verbose > 1) std::cout << "texel epoch " << epoch << " loss " << loss(ds, nullptr, n, w, nullptr) << std::endl;
+        }
+        return true;
+    }
+
+    // tune_lbfgs() - full batch, loss and gradient from one pass (dlib asks f(x) then der(x) at the same x)
+    inline bool TexelTuner::tune_lbfgs(const FeatureDataset& ds, std::vector<double>& w, double weight_bound, char verbose, TexelTunerResult& r)
+    {
+        const size_t max_iter = options()._epochs;
+        typedef dlib::matrix<double, 0, 1> column_vector;
+        size_t nf = ds._nfeature;
+        column_vector x(nf);
+        for (size_t i = 0; i < nf; i++) x(i) = w[i];
+
+        column_vector last_x;
+        std::vector<double> wv(nf), g;
+        auto eval = [&](const column_vector& p)
+        {
+            if ((last_x.size() == p.size()) && (last_x == p)) return;
+            for (size_t i = 0; i < nf; i++) wv[i] = p(i);
+            loss(ds, nullptr, ds.size(), wv, &g);
+            last_x = p;
+            r._iterations++;
+        };
+        auto f = [&](const column_vector& p) -> double
+        {
+            for (size_t i = 0; i < nf; i++) wv[i] = p(i);
+            return loss(ds, nullptr, ds.size(), wv, nullptr);
+        };
+        auto der = [&](const column_vector& p) -> column_vector
+        {
+            eval(p);
+            column_vector d(nf);
+            for (size_t i = 0; i < nf; i++) d(i) = g[i];
+            return d;
+        };
+
+        try
+        {
+            dlib::objective_delta_stop_strategy stop(1e-10, (unsigned long)max_iter);
+            if (verbose > 1) stop.be_verbose();
+            if (weight_bound > 0)
+                dlib::find_min_box_constrained(dlib::lbfgs_search_strategy(10), stop, f, der, x, -weight_bound, weight_bound);
+            else
+                dlib::find_min(dlib::lbfgs_search_strategy(10), stop, f, der, x, -std::numeric_limits<double>::infinity());
+        }
+        catch (std::exception& e)
+        {
+            std::stringstream ss_detail;
+            ss_detail << "texel tuner lbfgs: " << e.what();
+            std::cerr << ss_detail.str() << std::endl;
+        }
+        for (size_t i = 0; i < nf; i++) w[i] = x(i);
+        clamp(w, weight_bound);
+        return true;
+    }
+
+    // FeatureTexelTuner
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    class FeatureTexelTuner
+    {
+        using _ConditionValuationNode = ConditionValuationNode<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _DomainPlayer = DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _FeatureDatasetBuilder = FeatureDatasetBuilder<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _FeatureValuAlgo_weight_sum = FeatureValuAlgo_weight_sum<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+
+    public:
+        // tune() - weights of algo (valuations already loaded) on the first max_samples labelled positions of node, |w| <= weight_bound (0 = none)
+        static bool tune(_DomainPlayer& player, _ConditionValuationNode* node, _FeatureValuAlgo_weight_sum& algo, size_t max_samples, char verbose,
+                         double weight_bound = TexelTuner::weight_bound(), TexelTunerResult* ret_result = nullptr);
+    };
+
+    // tune()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    bool FeatureTexelTuner<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::
+    tune(_DomainPlayer& player, _ConditionValuationNode* node, _FeatureValuAlgo_weight_sum& algo, size_t max_samples, char verbose, double weight_bound, TexelTunerResult* ret_result)
+    {
+        if (algo.valuations().size() == 0) return false;
+
+        FeatureDataset ds;
+        if (!_FeatureDatasetBuilder::build(player, node, algo.valuations(), max_samples, ds)) return false;
+
+        // current weights as start point
+        std::vector<double> w(algo.valuations().size(), 0.0);
+        for (size_t i = 0; (i < w.size()) && (i < algo.weights().size()); i++) w[i] = (double)algo.weights()[i];
+
+        if (!TexelTuner::tune(ds, w, weight_bound, verbose, ret_result)) return false;
+
+        std::vector<TYPE_PARAM> weights(w.size());
+        for (size_t i = 0; i < w.size(); i++) weights[i] = (TYPE_PARAM)w[i];
+        algo.set_weights(weights);
+        return true;
+    }
+};
+
+#endif
@@ -20,7 +20,6 @@ namespace chess
         using _ConditionFeature = ConditionFeature<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
         using _ValuationFeature = ValuationFeature<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
         using _ConditionValuationNode = ConditionValuationNode<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
-        using _DomainPlayer     = DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
         using _FeatureAlgo      = FeatureAlgo<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
         using _FeatureCondAlgo  = FeatureCondAlgo<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
         using _FeatureValuAlgo  = FeatureValuAlgo<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
@@ -34,6 +33,9 @@ namespace chess
         CondValuNodeChanger() {}
         virtual ~CondValuNodeChanger() {}
 
+        static bool parallel_eval()             { return _parallel_eval; }
+        static void set_parallel_eval(bool v)   { _parallel_eval = v; }
+
     private:
         // try_expand_terminal_node_cond stuff - not owner
         _ConditionValuationNode*    node_parent = nullptr;
@@ -42,6 +44,8 @@ namespace chess
         _FeatureCondAlgo*           algo_cond_positive_child = nullptr;
         _FeatureValuAlgo*           algo_valu_positive_child = nullptr;
         _FeatureValuAlgo*           algo_valu_negative_child = nullptr;
+
+        static bool                 _parallel_eval;     // evaluate independent candidate algos concurrently
     
     public:
         // Try changing a player terminal node with 2 new child nodes[Fcond(0)/Fvalu(0) + !Fcond(0)/Fvalu(1)]
@@ -55,7 +59,7 @@ namespace chess
 
     protected:
         _ConditionValuationNode*    suggest_next_node_for_change(_DomainPlayer& player, bool changing_cond);
-        _FeatureAlgo*               suggest_algo_for_change(_DomainPlayer& player, _ConditionValuationNode* node, bool changing_cond);
+        virtual _FeatureAlgo*       suggest_algo_for_change(_DomainPlayer& player, _ConditionValuationNode* node, bool changing_cond);
 
         // Cond changer
         _ConditionValuationNode* suggest_next_node_for_cond_change(_DomainPlayer& player)
@@ -72,8 +76,9 @@ namespace chess
 
         bool eval_algo_for_cond_change(_DomainPlayer& player, _ConditionValuationNode* node, _FeatureCondAlgo* algo, size_t max_size_dataset, bool& ret_node_can_change)
         {
-            if (!node->set_test_cond_algo(algo))  return false;
-            return algo->train_test_compare(player, node, max_size_dataset, ret_node_can_change);
+            if (algo == nullptr) return false;
+            node->set_test_cond_algo(algo);
+            return algo->train_test_compare(player, node, max_size_dataset, 0, ret_node_can_change);
         }
 
         // Valu changer
@@ -89,17 +94,28 @@ namespace chess
             else return (_FeatureValuAlgo*)algo;
         }
 
-        bool eval_algo_for_valu_change(_DomainPlayer& player, _ConditionValuationNode* node, _FeatureValuAlgo* algo, size_t max_size_dataset)
+        bool eval_algo_for_valu_change(_DomainPlayer& player, _ConditionValuationNode* node, _FeatureValuAlgo* algo, size_t max_size_dataset, bool& ret_node_can_change)
+        {
+            if (algo == nullptr) return false;
+            node->set_test_valu_algo(algo);
+            return algo->train_test_compare(player, node, max_size_dataset, 0, ret_node_can_change);
+        }
+
+        // clone_of() - node of a cloned tree at the place of node in the source tree (clone_tree keeps the shape)
+        static _ConditionValuationNode* clone_of(_ConditionValuationNode* src, _ConditionValuationNode* clone, const _ConditionValuationNode* node)
         {
-            if (!node->set_test_valu_algo(algo))  return false;
-            return algo->train_test_compare(player, node, max_size_dataset, ret_node_to_change);
+            if ((src == nullptr) || (clone == nullptr)) return nullptr;
+            if (src == node) return clone;
+            _ConditionValuationNode* r = clone_of(src->_positive_child, clone->_positive_child, node);
+            if (r == nullptr) r = clone_of(src->_negative_child, clone->_negative_child, node);
+            return r;
         }
 
         void cleanup_try_expand_terminal_node_cond(_ConditionValuationNode* node_parent, bool undo = true)
         {
             if (undo)
             {
-                clear_child_cond_valu_algo();
+                node_parent->clear_child_cond_valu_algo();
 
                 if (node_parent->_positive_child != nullptr)
                 {
@@ -118,6 +134,9 @@ namespace chess
         }
     };
 
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    bool CondValuNodeChanger<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::_parallel_eval = true;
+
     // try_expand_terminal_node_cond
     template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
     bool CondValuNodeChanger<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::
@@ -147,22 +166,53 @@ namespace chess
 
         bool r[3];
         bool ret_node_can_change[3];
+        player.invalidate_eval_cache();
 
-        // make multi-threads..
+        // Fcond(0) first: the datasets of Fvalu(0) and Fvalu(1) are filtered by the node path, so they depend on the trained condition
         r[0] = eval_algo_for_cond_change(player, node_positive_child, algo_cond_positive_child, max_size_dataset, ret_node_can_change[0]); // Fcond(0)
         if (!r[0]) { cleanup_try_expand_terminal_node_cond(node_parent); return false; }
-        r[1] = eval_algo_for_valu_change(player, node_positive_child, algo_valu_positive_child, max_size_dataset, ret_node_can_change[1]); // Fvalu(0)
-        if (!r[1]) { cleanup_try_expand_terminal_node_cond(node_parent); return false; }
-        r[2] = eval_algo_for_valu_change(player, node_negative_child, algo_valu_negative_child, max_size_dataset, ret_node_can_change[2]); // Fvalu(1)
-        if (!r[2]) { cleanup_try_expand_terminal_node_cond(node_parent); return false; }
-
-        // compare if less error, commit_undo
-        if (node_parent->current_cond_algo()->cfg()._test_dataset_average_error >=                          // may compute split error before algo testing... 0.10 == .08+.12/2
-            std::max<double>(node_positive_child->test_cond_algo()->cfg()._test_dataset_average_error,      // if avg_better  [0.10 == .08+.12/2]  => .09+.10/2 (possible degrade in one child)
-                node_negative_child->test_cond_algo()->cfg()._test_dataset_average_error))                  // if both_better [0.10 == .08+.12/2]  => .08+.11/2 ok all better
+
+        // Fvalu(0) and Fvalu(1) each own their algo and dataset and walk the domain with their own cursor.
+        // Fvalu(1) is trained on a clone of the player (own node tree), its trained algo is then copied back in node_negative_child.
+        // Each training gets half of the threads for its own parallel sections (dataset shards, cross validation).
+        // Results are kept per candidate index so the decision below is the same as in sequential order.
+        if (_parallel_eval)
+        {
+            unsigned share = std::max<unsigned>(1, thread_concurrency() / 2);
+            std::unique_ptr<_DomainPlayer> player_negative(player.clone());
+            _ConditionValuationNode* clone_negative = clone_of(player.get_root(), player_negative->get_root(), node_negative_child);
+
+            std::future<bool> fut = std::async(std::launch::async, [&]() 
+            {
+                ConcurrencyScope scope(share);
+                return eval_algo_for_valu_change(*player_negative, clone_negative, clone_negative->test_valu_algo(), max_size_dataset, ret_node_can_change[2]); // Fvalu(1)
+            });
+            {
+                ConcurrencyScope scope(share);
+                r[1] = eval_algo_for_valu_change(player, node_positive_child, algo_valu_positive_child, max_size_dataset, ret_node_can_change[1]); // Fvalu(0)
+            }
+            r[2] = fut.get();
+            if (r[2])
+            {
+                algo_valu_negative_child = (_FeatureValuAlgo*)clone_negative->test_valu_algo()->clone();
+                node_negative_child->set_test_valu_algo(algo_valu_negative_child);
+            }
+        }
+        else
+        {
+            r[1] = eval_algo_for_valu_change(player, node_positive_child, algo_valu_positive_child, max_size_dataset, ret_node_can_change[1]); // Fvalu(0)
+            r[2] = r[1] && eval_algo_for_valu_change(player, node_negative_child, algo_valu_negative_child, max_size_dataset, ret_node_can_change[2]); // Fvalu(1)
+        }
+        if (!r[1] || !r[2]) { cleanup_try_expand_terminal_node_cond(node_parent); return false; }
+
+        // compare if less error, commit_undo: both children valuations must do at least as well as the parent one (none: any split is better)
+        double parent_error = (node_parent->current_valu_algo() != nullptr) ? node_parent->current_valu_algo()->cfg()._test_dataset_average_error : std::numeric_limits<double>::max();
+        if (parent_error >=                                                                                 // may compute split error before algo testing... 0.10 == .08+.12/2
+            std::max<double>(node_positive_child->test_valu_algo()->cfg()._test_dataset_average_error,      // if avg_better  [0.10 == .08+.12/2]  => .09+.10/2 (possible degrade in one child)
+                node_negative_child->test_valu_algo()->cfg()._test_dataset_average_error))                  // if both_better [0.10 == .08+.12/2]  => .08+.11/2 ok all better
         {
             ret_node_changed = true;
-            update_child_cond_valu_algo();
+            node_parent->update_child_cond_valu_algo();
 
             node_positive_child->save_root();
             node_negative_child->save_root();
@@ -172,11 +222,12 @@ namespace chess
         else
         {
             // no improvement
-            update_child_cond_valu_algo(true);
+            node_parent->update_child_cond_valu_algo(true);
 
             node_parent->save_root(); // keep histo
             cleanup_try_expand_terminal_node_cond(node_parent, true);
         }
+        player.invalidate_eval_cache();
         return true;
     }
 
@@ -191,10 +242,10 @@ namespace chess
 
         _FeatureCondAlgo* algo = suggest_algo_for_cond_change(player, node);
         if (algo == nullptr) return false;
-        if (!node->set_test_cond_algo(algo)) return false;
+        player.invalidate_eval_cache();
 
-        bool ret_node_to_change;
-        bool r = eval_algo_for_cond_change(player, node, algo, max_size_dataset, ret_node_to_change);
+        bool ret_node_can_change;
+        bool r = eval_algo_for_cond_change(player, node, algo, max_size_dataset, ret_node_can_change);
         if (r)
         {
             if (commit_undo)
@@ -212,6 +263,7 @@ namespace chess
             }
         }
         // extra cleanup... 
+        player.invalidate_eval_cache();
         return r;
     }
 
@@ -226,7 +278,7 @@ namespace chess
 
         _FeatureValuAlgo* algo = suggest_algo_for_valu_change(player, node);       // node owner
         if (algo == nullptr) return false;
-        if (!node->set_test_valu_algo(algo)) return false;
+        player.invalidate_eval_cache();
 
         bool ret_node_can_change;
         bool r = eval_algo_for_valu_change(player, node, algo, max_size_dataset, ret_node_can_change);
@@ -247,6 +299,7 @@ namespace chess
             }
         }
         // extra cleanup...            
+        player.invalidate_eval_cache();
         return r;
     }
 
@@ -297,7 +350,7 @@ namespace chess
         size_t attempt = 0;
         while (true)
         {
-            size_t r = (size_t)uniform_double(rnd_generator) * nabove;
+            size_t r = (size_t)(thread_rng().uniform_double() * nabove);
             size_t cnt = 0;
             for (size_t i = 0; i < player_terminal_nodes.size(); i++)
             {
@@ -378,7 +431,7 @@ namespace chess
                     _ConditionFeature* f = _FeatureManager::instance()->get_cond_feature(i);
                     if (player.domain()->is_cond_feature_valid(*f))
                     {
-                        if (uniform_double(rnd_generator) >= 0.50)
+                        if (thread_rng().uniform_double() >= 0.50)
                         {
                             v_primitive_features.push_back(_FeatureManager::instance()->get_cond_feature_fullname(i));
                         }
@@ -389,7 +442,7 @@ namespace chess
                     _ValuationFeature* f = _FeatureManager::instance()->get_valu_feature(i);
                     if (player.domain()->is_valu_feature_valid(*f))
                     {
-                        if (uniform_double(rnd_generator) >= 0.50)
+                        if (thread_rng().uniform_double() >= 0.50)
                         {
                             v_primitive_features.push_back(_FeatureManager::instance()->get_valu_feature_fullname(i));
                         }
@@ -426,7 +479,7 @@ namespace chess
             }
             if (v_cfg.size() == 0) continue;
 
-            size_t r = (size_t)uniform_double(rnd_generator) * v_cfg.size();
+            size_t r = (size_t)thread_rng().below(v_cfg.size());
             if ((r >= 0) && (r < v_cfg.size()))
             {
                 return _FeatureAlgo::create(v_cfg[r]);
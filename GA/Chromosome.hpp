@@ -6,6 +6,8 @@
 //
 //  class Chromosome<T, PARAM_NBIT>
 //
+//  The genome is packed in uint64_t words, bit pos is bit (pos % 64) of word (pos / 64).
+//  Gene k is the PARAM_NBIT bits value at bit idx[k], low bit first. Unused bits of the last word stay 0.
 //
 #ifndef _AL_CHESS_GA_CHROMOSOME_HPP
 #define _AL_CHESS_GA_CHROMOSOME_HPP
@@ -23,15 +25,23 @@ namespace galgo
        void create();
        void initialize();
        void evaluate(bool is_at_creation = false);
+       const std::vector<T>& decode();                   // evaluate() in 2 steps: decode(), objective(s) computed elsewhere,
+       void set_result(const std::vector<T>& r);         // then set_result() (Ex: GeneticAlgorithm::evaluate_batch())
        void reset();
        void setGene(int k);
        void initGene(int k, T value);
-       void addBit(char bit);
        void setBit(char bit, int pos);
        void flipBit(int pos);
        char getBit(int pos) const;
        void setPortion(const Chromosome<T, PARAM_NBIT>& x, int start, int end);
        void setPortion(const Chromosome<T, PARAM_NBIT>& x, int start);
+       void setMasked(const Chromosome<T, PARAM_NBIT>& x, const Chromosome<T, PARAM_NBIT>& y, int w, uint64_t mask); // word w: x bits where mask is 1, y bits elsewhere
+       int nbword() const;
+       uint64_t wordMask(int w) const;                   // used bits of word w
+       const std::vector<uint64_t>& words() const;       // packed bits (Ex: island migration)
+       void setWords(const std::vector<uint64_t>& w);
+       void write(std::ostream& os) const;               // binary state (Ex: GA checkpoint)
+       bool read(std::istream& is);
        const std::vector<T>& getParam() const;
        const std::vector<T>& getResult() const;
        T getTotal() const;
@@ -46,9 +56,12 @@ namespace galgo
        std::vector<T> decode_param();
 
     private:
+       uint64_t getBits(int pos, int n) const;
+       void setBits(int pos, int n, uint64_t value);
+
        std::vector<T> param;                     // estimated parameter(s)
        std::vector<T> result;                    // chromosome objective function(s) result
-       std::string chr;                          // string of bits representing chromosome
+       std::vector<uint64_t> chr;                // packed bits representing chromosome
        const GeneticAlgorithm<T, PARAM_NBIT>* ptr = nullptr; // pointer to genetic algorithm
     public:
        T fitness;                                // chromosome fitness, objective function(s) result that can be modified (adapted to constraint(s), set to positive values, etc...)
@@ -66,6 +79,7 @@ namespace galgo
        ptr = &ga;
        chrsize = ga.nbbit;
        numgen = ga.nogen;
+       chr.assign((chrsize + 63) / 64, 0);
     }
 
     // copy constructor
@@ -87,12 +101,11 @@ namespace galgo
     template <typename T, int PARAM_NBIT>
     inline void Chromosome<T, PARAM_NBIT>::create()
     {
-       chr.clear();
-
+       int i(0);
        for (const auto& x : ptr->param) {
           // encoding parameter random value
-          std::string str = x->encode();
-          chr.append(str);
+          setBits(ptr->idx[i], x->size(), x->encode());
+          i++;
        }  
     }
 
@@ -100,14 +113,12 @@ namespace galgo
     template <typename T, int PARAM_NBIT>
     inline void Chromosome<T, PARAM_NBIT>::initialize()
     {
-       chr.clear();
-
        int i(0);
        for (const auto& x : ptr->param) 
        {
           // encoding parameter initial value
-          std::string str = x->encode(ptr->initialSet[i++]);
-          chr.append(str);
+          setBits(ptr->idx[i], x->size(), x->encode(ptr->initialSet[i]));
+          i++;
        }      
     }
 
@@ -117,8 +128,8 @@ namespace galgo
     {
         int i(0);
         for (const auto& x : ptr->param) {
-            // decoding chromosome: converting chromosome string into a real value
-            param[i] = x->decode(chr.substr(ptr->idx[i], x->size()));
+            // decoding chromosome: converting gene bits into a real value
+            param[i] = x->decode(getBits(ptr->idx[i], x->size()));
             i++;
         }
         std::vector<T> v = param;
@@ -129,32 +140,47 @@ namespace galgo
     template <typename T, int PARAM_NBIT>
     inline void Chromosome<T, PARAM_NBIT>::evaluate(bool is_at_creation) 
     {
-       int i(0);
-       for (const auto& x : ptr->param) {
-          // decoding chromosome: converting chromosome string into a real value
-          param[i] = x->decode(chr.substr(ptr->idx[i], x->size()));
-	      i ++ ;
-       } 
+       decode();
        // computing objective result(s) 
        if (ptr->Objective != nullptr)
-            result = ptr->Objective(param);
+            set_result(ptr->Objective(param));
        else
        {
-           result = ptr->tournament(is_at_creation, param);
+           set_result(ptr->tournament(is_at_creation, param));
        }
+    } 
+
+    // decode chromosome parameter(s)
+    template <typename T, int PARAM_NBIT>
+    inline const std::vector<T>& Chromosome<T, PARAM_NBIT>::decode()
+    {
+       int i(0);
+       for (const auto& x : ptr->param) {
+          // decoding chromosome: converting gene bits into a real value
+          param[i] = x->decode(getBits(ptr->idx[i], x->size()));
+	      i ++ ;
+       } 
+       return param;
+    }
+
+    // set objective result(s) of the decoded parameter(s)
+    template <typename T, int PARAM_NBIT>
+    inline void Chromosome<T, PARAM_NBIT>::set_result(const std::vector<T>& r)
+    {
+       result = r;
 
        // computing sum of all results (in case there is not only one objective functions)
        total = std::accumulate(result.begin(), result.end(), 0.0);
 
        // initializing fitness to this total
        fitness = total;
-    } 
+    }
 
     // reset chromosome
     template <typename T, int PARAM_NBIT>
     inline void Chromosome<T, PARAM_NBIT>::reset()
     {
-       chr.clear();
+       std::fill(chr.begin(), chr.end(), 0);
        result = 0.0;
        total = 0.0;
        fitness = 0.0;
@@ -170,10 +196,8 @@ namespace galgo
        }
        #endif
 
-       // generating a new gene
-       std::string s = ptr->param[k]->encode();
-       // adding or replacing gene in chromosome
-       chr.replace(ptr->idx[k], s.size(), s, 0, s.size());
+       // generating a new gene and replacing it in chromosome
+       setBits(ptr->idx[k], ptr->param[k]->size(), ptr->param[k]->encode());
     }
 
     // initialize or replace kth gene by a know value
@@ -186,23 +210,8 @@ namespace galgo
        }
        #endif
 
-       // encoding gene
-       std::string s = ptr->param[k]->encode(x);
-       // adding or replacing gene in chromosome
-       chr.replace(ptr->idx[k], s.size(), s, 0, s.size());
-    }
-
-    // add chromosome bit to chromosome (when constructing a new one)
-    template <typename T, int PARAM_NBIT>
-    inline void Chromosome<T, PARAM_NBIT>::addBit(char bit)
-    {
-       chr.push_back(bit);
-
-       #ifndef NDEBUG
-       if (chr.size() > chrsize) {
-          throw std::out_of_range("Error: in galgo::Chromosome<T, PARAM_NBIT>::setBit(char), exceeding chromosome size.");
-       }
-       #endif
+       // encoding gene and replacing it in chromosome
+       setBits(ptr->idx[k], ptr->param[k]->size(), ptr->param[k]->encode(x));
     }
 
     // initialize or replace an existing chromosome bit   
@@ -215,12 +224,7 @@ namespace galgo
        }
        #endif
 
-       std::stringstream ss;
-       std::string str;
-       ss << bit;
-       ss >> str;
-       chr.replace(pos, 1, str);
-       std::cout << chr << " ";
+       setBits(pos, 1, (bit == '1') ? 1 : 0);
     }
 
     // flip an existing chromosome bit
@@ -233,11 +237,7 @@ namespace galgo
        }
        #endif
 
-       if (chr[pos] == '0') {
-          chr.replace(pos, 1, "1");
-       } else {
-          chr.replace(pos, 1, "0");
-       }
+       chr[pos >> 6] ^= (uint64_t)1 << (pos & 63);
     }
 
     // get a chromosome bit
@@ -250,7 +250,7 @@ namespace galgo
        }
        #endif
 
-       return chr[pos];
+       return getBits(pos, 1) ? '1' : '0';
     }
 
     // initialize or replace a portion of bits with a portion of another chromosome (from position start to position end included)
@@ -263,7 +263,19 @@ namespace galgo
        }
        #endif
 
-       chr.replace(start, end - start + 1, x.chr, start, end - start + 1);
+       end = std::min(end, chrsize - 1);
+       if (end < start) return;
+
+       // masked copy of the words spanning [start, end]
+       int w0 = start >> 6;
+       int w1 = end >> 6;
+       for (int w = w0; w <= w1; w++)
+       {
+          uint64_t mask = wordMask(w);
+          if (w == w0) mask &= ~(uint64_t)0 << (start & 63);
+          if (w == w1) mask &= ~(uint64_t)0 >> (63 - (end & 63));
+          chr[w] = (chr[w] & ~mask) | (x.chr[w] & mask);
+       }
     }
 
     // initialize or replace a portion of bits with a portion of another chromosome (from position start to the end of he chromosome)
@@ -276,7 +288,98 @@ namespace galgo
        }
        #endif
 
-       chr.replace(start, chrsize, x.chr, start, x.chrsize);
+       setPortion(x, start, chrsize - 1);
+    }
+
+    // set word w from 2 chromosomes: bits of x where mask is 1, bits of y elsewhere
+    template <typename T, int PARAM_NBIT>
+    inline void Chromosome<T, PARAM_NBIT>::setMasked(const Chromosome<T, PARAM_NBIT>& x, const Chromosome<T, PARAM_NBIT>& y, int w, uint64_t mask)
+    {
+       chr[w] = ((x.chr[w] & mask) | (y.chr[w] & ~mask)) & wordMask(w);
+    }
+
+    // return number of words of the packed chromosome
+    template <typename T, int PARAM_NBIT>
+    inline int Chromosome<T, PARAM_NBIT>::nbword() const
+    {
+       return (int)chr.size();
+    }
+
+    // return mask of the used bits of word w (all but the tail of the last word)
+    template <typename T, int PARAM_NBIT>
+    inline uint64_t Chromosome<T, PARAM_NBIT>::wordMask(int w) const
+    {
+       int n = chrsize - 64 * w;
+       return (n >= 64) ? ~(uint64_t)0 : (((uint64_t)1 << n) - 1);
+    }
+
+    // return packed bits of chromosome
+    template <typename T, int PARAM_NBIT>
+    inline const std::vector<uint64_t>& Chromosome<T, PARAM_NBIT>::words() const
+    {
+       return chr;
+    }
+
+    // set packed bits of chromosome (from another chromosome of the same size)
+    template <typename T, int PARAM_NBIT>
+    inline void Chromosome<T, PARAM_NBIT>::setWords(const std::vector<uint64_t>& w)
+    {
+       #ifndef NDEBUG
+       if (w.size() != chr.size()) {
+          throw std::invalid_argument("Error: in galgo::Chromosome<T, PARAM_NBIT>::setWords(const std::vector<uint64_t>&), argument size is not the chromosome number of words.");
+       }
+       #endif
+
+       for (int i = 0; i < (int)chr.size(); i++) chr[i] = w[i] & wordMask(i);
+    }
+
+    // write chromosome state (bits, parameters, results, fitness)
+    template <typename T, int PARAM_NBIT>
+    void Chromosome<T, PARAM_NBIT>::write(std::ostream& os) const
+    {
+       write_vector(os, chr);
+       write_vector(os, param);
+       write_vector(os, result);
+       write_pod(os, fitness);
+       write_pod(os, total);
+       write_pod(os, numgen);
+    }
+
+    // read chromosome state, false if it does not match the genetic algorithm
+    template <typename T, int PARAM_NBIT>
+    bool Chromosome<T, PARAM_NBIT>::read(std::istream& is)
+    {
+       size_t nword = chr.size();
+       if (!read_vector(is, chr, nword) || (chr.size() != nword)) return false;
+       if (!read_vector(is, param, ptr->nbparam) || (param.size() != (size_t)ptr->nbparam)) return false;
+       if (!read_vector(is, result, 1024)) return false;
+       return read_pod(is, fitness) && read_pod(is, total) && read_pod(is, numgen);
+    }
+
+    // get n bits (n in [1,64]) from position pos, low bit first
+    template <typename T, int PARAM_NBIT>
+    inline uint64_t Chromosome<T, PARAM_NBIT>::getBits(int pos, int n) const
+    {
+       int w = pos >> 6;
+       int off = pos & 63;
+       uint64_t v = chr[w] >> off;
+       if (off + n > 64) v |= chr[w + 1] << (64 - off);
+       return (n == 64) ? v : (v & (((uint64_t)1 << n) - 1));
+    }
+
+    // set n bits (n in [1,64]) at position pos, low bit first
+    template <typename T, int PARAM_NBIT>
+    inline void Chromosome<T, PARAM_NBIT>::setBits(int pos, int n, uint64_t value)
+    {
+       uint64_t mask = (n == 64) ? ~(uint64_t)0 : (((uint64_t)1 << n) - 1);
+       value &= mask;
+       int w = pos >> 6;
+       int off = pos & 63;
+       chr[w] = (chr[w] & ~(mask << off)) | (value << off);
+       if (off + n > 64) {
+          int shift = 64 - off;
+          chr[w + 1] = (chr[w + 1] & ~(mask >> shift)) | (value >> shift);
+       }
     }
 
     // get parameter value(s) from chromosome
@@ -6,6 +6,7 @@
 //
 //  std::string GetBinary(uint64_t value)
 //  uint64_t    GetValue(const std::string& s)
+//  write_pod(), read_pod(), write_vector(), read_vector() : binary stream of POD values (Ex: GA checkpoint)
 //
 //
 #ifndef _AL_CHESS_GA_CONVERTER_HPP
@@ -31,6 +32,38 @@ namespace galgo
        memcpy(&value, &x, sizeof(uint64_t));
        return value;
     }
+
+    template <typename V>
+    void write_pod(std::ostream& os, const V& v)
+    {
+       os.write((const char*)&v, sizeof(V));
+    }
+
+    template <typename V>
+    bool read_pod(std::istream& is, V& v)
+    {
+       is.read((char*)&v, sizeof(V));
+       return is.good();
+    }
+
+    // vector as uint64_t size then values
+    template <typename V>
+    void write_vector(std::ostream& os, const std::vector<V>& v)
+    {
+       write_pod(os, (uint64_t)v.size());
+       if (!v.empty()) os.write((const char*)v.data(), v.size() * sizeof(V));
+    }
+
+    // read_vector() - false if the size is above max_size (corrupted stream)
+    template <typename V>
+    bool read_vector(std::istream& is, std::vector<V>& v, uint64_t max_size)
+    {
+       uint64_t n;
+       if (!read_pod(is, n) || (n > max_size)) return false;
+       v.resize((size_t)n);
+       if (n > 0) is.read((char*)v.data(), n * sizeof(V));
+       return is.good();
+    }
 }
 
 #endif
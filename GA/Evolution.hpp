@@ -17,7 +17,7 @@
 //  void P2XO(const galgo::Population<T, PARAM_NBIT>& x, galgo::CHR<T, PARAM_NBIT>& chr1, galgo::CHR<T, PARAM_NBIT>& chr2);
 //  void UXO (const galgo::Population<T, PARAM_NBIT>& x, galgo::CHR<T, PARAM_NBIT>& chr1, galgo::CHR<T, PARAM_NBIT>& chr2);
 //
-//  MUTATION METHODS
+//  MUTATION METHODS (a rate of p per bit/gene, drawn by geometric skips: one draw per mutation, not per bit/gene)
 //  void BDM(galgo::CHR<T, PARAM_NBIT>& chr);
 //  void SPM(galgo::CHR<T, PARAM_NBIT>& chr);
 //  void UNM(galgo::CHR<T, PARAM_NBIT>& chr);
@@ -224,7 +224,7 @@ namespace chess
             int popsize = x.popsize();
             // generating a random set of popsize values on [0,1)
             std::vector<T> r(popsize);
-            std::for_each(r.begin(), r.end(), [](T& z)->T {z = galgo::proba(galgo::rng); });
+            std::for_each(r.begin(), r.end(), [](T& z)->T {z = galgo::proba(); });
             // sorting them from highest to lowest
             std::sort(r.begin(), r.end(), [](T z1, T z2)->bool {return z1 > z2; });
             // transforming population fitness
@@ -305,23 +305,32 @@ namespace chess
             int idx1 = galgo::uniform<int>(0, x.matsize());
             int idx2 = galgo::uniform<int>(0, x.matsize());
 
-            for (int j = 0; j < chr1->size(); ++j) {
-                // choosing 1 of the 2 chromosomes randomly
-                if (galgo::proba(galgo::rng) < 0.50) {
-                    // adding its jth bit to new chromosome
-                    chr1->addBit(x[idx1]->getBit(j));
-                    chr2->addBit(x[idx2]->getBit(j));
-                }
-                else {
-                    // adding its jth bit to new chromosomes
-                    chr1->addBit(x[idx2]->getBit(j));
-                    chr2->addBit(x[idx1]->getBit(j));
-                }
+            for (int w = 0; w < chr1->nbword(); ++w) {
+                // choosing 1 of the 2 chromosomes randomly for each bit of the word
+                uint64_t mask = chess::thread_rng()();
+                chr1->setMasked(*x[idx1], *x[idx2], w, mask);
+                chr2->setMasked(*x[idx2], *x[idx1], w, mask);
             }
         }
 
         // MUTATION METHODS
 
+        // number of failures before the next success of probability p (geometric distribution)
+        inline int geometric_skip(double p)
+        {
+            if (p >= 1.0) return 0;
+            double u = 1.0 - galgo::proba(); // (0,1]
+            double k = std::floor(std::log(u) / std::log1p(-p));
+            return (k >= (double)INT_MAX) ? INT_MAX : (int)k;
+        }
+
+        // next index in [i, n) selected with probability p, n if none
+        inline int geometric_next(int i, int n, double p)
+        {
+            int skip = geometric_skip(p);
+            return (skip >= n - i) ? n : i + skip;
+        }
+
         // boundary mutation: replacing a chromosome gene by its lower or upper bound
         template <typename T, int PARAM_NBIT>
         void BDM(galgo::CHR<T, PARAM_NBIT>& chr)
@@ -335,19 +344,17 @@ namespace chess
             // getting chromosome upper bound(s)
             const std::vector<T>& upperBound = chr->upperBound();
 
-            // looping on number of genes
-            for (int i = 0; i < chr->nbgene(); ++i) {
+            // looping on selected genes
+            int n = chr->nbgene();
+            for (int i = geometric_next(0, n, mutrate); i < n; i = geometric_next(i + 1, n, mutrate)) {
                 // generating a random probability
-                if (galgo::proba(galgo::rng) <= mutrate) {
-                    // generating a random probability
-                    if (galgo::proba(galgo::rng) < .5) {
-                        // replacing ith gene by lower bound
-                        chr->initGene(i, lowerBound[i]);
-                    }
-                    else {
-                        // replacing ith gene by upper bound
-                        chr->initGene(i, upperBound[i]);
-                    }
+                if (galgo::proba() < .5) {
+                    // replacing ith gene by lower bound
+                    chr->initGene(i, lowerBound[i]);
+                }
+                else {
+                    // replacing ith gene by upper bound
+                    chr->initGene(i, upperBound[i]);
                 }
             }
         }
@@ -360,13 +367,11 @@ namespace chess
 
             if (mutrate == 0.0) return;
 
-            // looping on chromosome bits
-            for (int i = 0; i < chr->size(); ++i) {
-                // generating a random probability
-                if (galgo::uniform_double(galgo::rnd_generator) <= mutrate) {
-                    // flipping ith bit
-                    chr->flipBit(i);
-                }
+            // looping on selected chromosome bits
+            int n = chr->size();
+            for (int i = geometric_next(0, n, mutrate); i < n; i = geometric_next(i + 1, n, mutrate)) {
+                // flipping ith bit
+                chr->flipBit(i);
             }
         }
 
@@ -378,13 +383,11 @@ namespace chess
 
             if (mutrate == 0.0) return;
 
-            // looping on number of genes
-            for (int i = 0; i < chr->nbgene(); ++i) {
-                // generating a random probability
-                if (galgo::proba(galgo::rng) <= mutrate) {
-                    // replacing ith gene by a new one
-                    chr->setGene(i);
-                }
+            // looping on selected genes
+            int n = chr->nbgene();
+            for (int i = geometric_next(0, n, mutrate); i < n; i = geometric_next(i + 1, n, mutrate)) {
+                // replacing ith gene by a new one
+                chr->setGene(i);
             }
         }
 
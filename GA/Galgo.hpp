@@ -27,6 +27,9 @@
 #include <climits>
 #include <cmath>
 #include <cstring>
+#ifdef _WIN32
+#include <windows.h>    // MoveFileExA - checkpoint replaced in one step
+#endif
 
 namespace galgo
 {
@@ -54,6 +57,7 @@ namespace galgo
 #include "ga/Evolution.hpp"
 #include "ga/Chromosome.hpp"
 #include "ga/Population.hpp"
+#include "ga/Island.hpp"
 #include "ga/GeneticAlgorithm.hpp"
 #include "random.hpp"
 
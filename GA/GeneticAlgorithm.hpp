@@ -6,6 +6,12 @@
 //
 //  class GeneticAlgorithm<T, PARAM_NBIT>
 //
+//  Checkpoint: every checkpoint_step generations the run state is written (atomically) to checkpoint_file:
+//  counters, master seed (all random streams derive from seed, run, generation), best result history,
+//  current population and the state of a derived GA. resume() continues the run as if never stopped.
+//
+//  File layout: "ALGC" | version | sizeof(T) | PARAM_NBIT | nbbit | popsize | seed | rng_id | norun | nogen
+//               | history | population | write_state() of derived GA
 //
 #ifndef _AL_CHESS_GA_GENETICALGORITHM_HPP
 #define _AL_CHESS_GA_GENETICALGORITHM_HPP
@@ -47,6 +53,10 @@ namespace galgo
        int tntsize = 10;  // tournament size
        int genstep = 1;  // generation step for outputting results
        int precision = 5; // precision for outputting results
+       uint64_t rng_id = 0; // random streams of this GA (several GA sharing the master seed)
+       IslandConfig island; // island model (disabled by default)
+       std::string checkpoint_file; // checkpoint of the run state ("" : no checkpoint)
+       int checkpoint_step = 1;     // generations between checkpoints
 
     public:
        // constructor
@@ -58,7 +68,13 @@ namespace galgo
        GeneticAlgorithm(int popsize, int nbgen);
 
        virtual void run(bool reenty = false);       // run genetic algorithm  
+       virtual bool resume();                       // continue the run saved in checkpoint_file, false if none
        const CHR<T, PARAM_NBIT>& result() const;    // return best chromosome 
+       const std::vector<T>& best_history() const { return history; } // best total result per generation (0: creation)
+
+       bool save_checkpoint() const;                // write run state to checkpoint_file
+       bool load_checkpoint(bool commit = true, int* ret_nogen = nullptr); // read run state from checkpoint_file, false if none or another GA
+                                                                           // (commit false: only check the file and give its generation)
 
        virtual std::vector<T> tournament(bool is_at_creation, const std::vector<T>& param) const
        {
@@ -66,19 +82,41 @@ namespace galgo
            return v;
        }
 
+       // rng_stream - random stream of (run, generation, id, index) derived from the master seed
+       chess::CounterRng rng_stream(chess::RngStreamId id, uint64_t index = 0) const
+       {
+           return chess::RngMaster::stream(chess::RngStreamId::ga).stream(rng_id).stream(norun).stream(nogen).stream(id).stream(index);
+       }
+
+       // evaluate_batch - evaluate chromosomes [begin, end) of chrs (override to evaluate them concurrently)
+       virtual void evaluate_batch(std::vector<CHR<T, PARAM_NBIT>>& chrs, int begin, int end, bool is_at_creation) const
+       {
+           for (int i = begin; i < end; i++)
+               chrs[i]->evaluate(is_at_creation);
+       }
+
     protected:
        int nbbit;     // total number of bits per chromosome
        int nbgen;     // number of generations
        int nogen = 0; // numero of generation
+       int norun = 0; // numero of run (reentry runs draw new streams)
        int nbparam;   // number of parameters to be estimated
        int popsize;   // population size
        bool output;   // control if results must be outputted
+       std::vector<T> history; // best total result per generation
 
        //int tournament_n_player;
        //int tournament_n_game;
 
        void check() const ; // check inputs validity
        void print() const;  // print results for each new generation
+       void setup_island(); // island selection method
+       void migration();    // exchange migrants with the other islands
+       void evolve();       // evolve population from generation nogen + 1 to nbgen
+
+       bool checkpoint_due() const { return !checkpoint_file.empty() && ((nogen % checkpoint_step == 0) || (nogen == nbgen)); }
+       virtual void write_state(std::ostream& os) const {}     // state of a derived GA in checkpoint
+       virtual bool read_state(std::istream& is, bool commit) { return true; }
     };
 
     template <typename T, int PARAM_NBIT>
@@ -155,11 +193,13 @@ namespace galgo
     {
        // checking inputs validity
        this->check();
+       ++norun;
 
        // setting adaptation method to default if needed
        if (Constraint != nullptr && Adaptation == nullptr) {
           Adaptation = chess::ga::DAC;
        }
+       setup_island();
 
        // initializing population
        pop = Population<T, PARAM_NBIT>(*this);
@@ -172,28 +212,59 @@ namespace galgo
        // creating population
        pop.creation();
 
-       // initializing best result and previous best result
-       T bestResult = pop(0)->getTotal();
-       T prevBestResult = bestResult;
+       // initializing best result history
+       history.assign(1, pop(0)->getTotal());
 
        // outputting results 
        if (output) print();
-    
+
+       nogen = 0;
+       evolve();
+    }
+
+    // continue the run saved in checkpoint file
+    template <typename T, int PARAM_NBIT>
+    bool GeneticAlgorithm<T, PARAM_NBIT>::resume()
+    {
+       this->check();
+
+       if (Constraint != nullptr && Adaptation == nullptr) {
+          Adaptation = chess::ga::DAC;
+       }
+       setup_island();
+
+       if (!load_checkpoint()) return false;
+
+       if (output) {
+          std::cout << "\n Resuming Genetic Algorithm at generation " << nogen + 1 << "...\n";
+          std::cout << " ----------------------------\n";
+       }
+       evolve();
+       return true;
+    }
+
+    // evolve population from generation nogen + 1 to nbgen
+    template <typename T, int PARAM_NBIT>
+    void GeneticAlgorithm<T, PARAM_NBIT>::evolve()
+    {
        // starting population evolution
-       for (nogen = 1; nogen <= nbgen; ++nogen) 
+       for (nogen = nogen + 1; nogen <= nbgen; ++nogen) 
        {
           // evolving population
           pop.evolution();
+          // island model migration
+          if (island.enabled() && (nogen % island.interval == 0)) migration();
           // getting best current result
-          bestResult = pop(0)->getTotal();
+          history.push_back(pop(0)->getTotal());
           // outputting results
           if (output) print();
+          // saving run state
+          if (checkpoint_due()) save_checkpoint();
           // checking convergence
           if (tolerance != 0.0) {
-             if (fabs(bestResult - prevBestResult) < fabs(tolerance)) {
+             if (fabs(history[history.size() - 1] - history[history.size() - 2]) < fabs(tolerance)) {
                 break;
              }
-             prevBestResult = bestResult;
           }
        } 
 
@@ -218,6 +289,117 @@ namespace galgo
        }   
     }
 
+    // write run state to checkpoint file (write aside then rename: a crash never leaves a partial checkpoint)
+    template <typename T, int PARAM_NBIT>
+    bool GeneticAlgorithm<T, PARAM_NBIT>::save_checkpoint() const
+    {
+       std::string ftmp = checkpoint_file + ".tmp";
+       {
+          std::ofstream os;
+          os.open(ftmp.c_str(), std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+          if (!os.good()) return false;
+
+          os.write("ALGC", 4);
+          write_pod(os, (uint32_t)1);
+          write_pod(os, (uint32_t)sizeof(T));
+          write_pod(os, (uint32_t)PARAM_NBIT);
+          write_pod(os, (int32_t)nbbit);
+          write_pod(os, (int32_t)popsize);
+          write_pod(os, chess::RngMaster::seed());
+          write_pod(os, rng_id);
+          write_pod(os, (int32_t)norun);
+          write_pod(os, (int32_t)nogen);
+          write_vector(os, history);
+          pop.write(os);
+          write_state(os);
+
+          bool ok = !os.bad();
+          os.close();
+          if (!ok) {
+             std::remove(ftmp.c_str());
+             return false;
+          }
+       }
+       // replace in one step: the previous checkpoint stays until the new one is complete
+#ifdef _WIN32
+       bool replaced = (MoveFileExA(ftmp.c_str(), checkpoint_file.c_str(), MOVEFILE_REPLACE_EXISTING) != 0);
+#else
+       bool replaced = (std::rename(ftmp.c_str(), checkpoint_file.c_str()) == 0);
+#endif
+       if (!replaced) std::remove(ftmp.c_str());
+       return replaced;
+    }
+
+    // read run state from checkpoint file, restores the master seed
+    // (read into temporaries, the GA is only changed when the whole file is valid: a bad file leaves it as it was)
+    template <typename T, int PARAM_NBIT>
+    bool GeneticAlgorithm<T, PARAM_NBIT>::load_checkpoint(bool commit, int* ret_nogen)
+    {
+       std::ifstream is;
+       is.open(checkpoint_file.c_str(), std::ifstream::in | std::ifstream::binary);
+       if (!is.good()) return false;
+
+       char magic[4];
+       uint32_t version, size_t_param, nbit;
+       int32_t n_bbit, n_pop, n_run, n_gen;
+       uint64_t seed, id;
+       is.read(magic, 4);
+       if (!is.good() || std::memcmp(magic, "ALGC", 4) != 0) return false;
+       if (!read_pod(is, version) || (version != 1)) return false;
+       if (!read_pod(is, size_t_param) || (size_t_param != sizeof(T))) return false;
+       if (!read_pod(is, nbit) || (nbit != PARAM_NBIT)) return false;
+       if (!read_pod(is, n_bbit) || (n_bbit != nbbit)) return false;
+       if (!read_pod(is, n_pop) || (n_pop != popsize)) return false;
+       if (!read_pod(is, seed) || !read_pod(is, id) || (id != rng_id)) return false;
+       if (!read_pod(is, n_run) || !read_pod(is, n_gen)) return false;
+
+       std::vector<T> h;
+       if (!read_vector(is, h, (uint64_t)n_gen + 1)) return false;
+       Population<T, PARAM_NBIT> p(*this);
+       if (!p.read(is)) return false;
+       if (!read_state(is, commit)) return false;  // derived state: also changed only on success
+
+       if (ret_nogen != nullptr) *ret_nogen = n_gen;
+       if (!commit) return true;
+
+       chess::RngMaster::set_seed(seed);
+       norun = n_run;
+       nogen = n_gen;
+       history.swap(h);
+       std::swap(pop, p);
+       return true;
+    }
+
+    // set island selection method if any
+    template <typename T, int PARAM_NBIT>
+    void GeneticAlgorithm<T, PARAM_NBIT>::setup_island()
+    {
+       if (!island.enabled()) return;
+       auto f = island_selection<T, PARAM_NBIT>(island.selection_name());
+       if (f != nullptr) Selection = f;
+    }
+
+    // send best chromosomes to the destination island, replace worst ones by the migrants of the source islands
+    template <typename T, int PARAM_NBIT>
+    void GeneticAlgorithm<T, PARAM_NBIT>::migration()
+    {
+       IslandChannel channel(island, rng_id);
+
+       std::vector<std::vector<uint64_t>> migrants;
+       for (int i = 0; i < std::min(island.nbmigrant, popsize); i++) {
+          migrants.push_back(pop(i)->words());
+       }
+       channel.send(island.destination(island.island, norun, nogen), norun, nogen, migrants);
+
+       std::vector<std::vector<uint64_t>> received;
+       for (int src : island.sources(norun, nogen)) {
+          if (!channel.receive(src, norun, nogen, received) && output) {
+             std::cout << " Island " << island.island << ": no migrant from island " << src << " (generation " << nogen << ")\n";
+          }
+       }
+       pop.immigration(received);
+    }
+
     // return best chromosome
     template <typename T, int PARAM_NBIT>
     inline const CHR<T, PARAM_NBIT>& GeneticAlgorithm<T, PARAM_NBIT>::result() const
@@ -0,0 +1,248 @@
+#pragma once
+//=================================================================================================
+//                    Copyright (C) 2017 Alain Lanthier - All Rights Reserved                      
+//=================================================================================================
+//
+//  IslandConfig    : island model settings of a process (island index, topology, migration rate)
+//  IslandChannel   : migrants exchange through files of a local directory (no network)
+//  run_islands()   : launch one local process per island and wait for them
+//
+//  Each island is a process evolving its own population with its own seed (and optionally its own
+//  selection method). Every interval generations, an island sends its nbmigrant best chromosomes to
+//  its destination island and replaces its worst ones by the migrants it receives.
+//  The topology only depends on the base seed shared by all islands: each island knows its sources.
+//
+#ifndef _AL_CHESS_GA_ISLAND_HPP
+#define _AL_CHESS_GA_ISLAND_HPP
+
+namespace galgo
+{
+    enum class IslandTopology { ring, random };
+
+    // IslandConfig - island < 0: no island model in this process
+    struct IslandConfig
+    {
+        int             island = -1;
+        int             nbisland = 1;
+        IslandTopology  topology = IslandTopology::ring;
+        int             interval = 5;           // generations between migrations
+        int             nbmigrant = 2;          // best chromosomes sent per migration
+        int             timeout_ms = 60000;     // wait on incoming migrants, then go on without them
+        int             numa_nodes = 0;         // launcher binds island i to node (i % numa_nodes), 0: no binding
+        uint64_t        seed = 0;               // base seed shared by all islands
+        std::string     dir = ".";              // channel directory on the local file system
+        std::vector<std::string> selection;     // selection method per island (cycled), empty: GA default
+
+        bool enabled() const { return (island >= 0) && (nbisland > 1); }
+
+        // island_seed() - master seed of this island process
+        uint64_t island_seed() const { return chess::hash_mix64(seed ^ chess::hash_mix64((uint64_t)island + 1)); }
+
+        // selection_name() - selection method of this island, empty: GA default
+        std::string selection_name() const { return selection.empty() ? "" : selection[island % selection.size()]; }
+
+        // destination() - island receiving the migrants of island src for migration (norun, nogen)
+        int destination(int src, int norun, int nogen) const
+        {
+            if (topology == IslandTopology::ring) return (src + 1) % nbisland;
+
+            chess::CounterRng rng = chess::CounterRng(seed).stream(chess::RngStreamId::ga_migration).stream(norun).stream(nogen).stream(src);
+            int d = (int)rng.below(nbisland - 1);
+            return (d >= src) ? d + 1 : d;
+        }
+
+        // sources() - islands sending their migrants to this island
+        std::vector<int> sources(int norun, int nogen) const
+        {
+            std::vector<int> v;
+            for (int src = 0; src < nbisland; src++)
+                if ((src != island) && (destination(src, norun, nogen) == island)) v.push_back(src);
+            return v;
+        }
+
+        // args() - command line arguments of island i
+        std::string args(int i) const
+        {
+            std::stringstream ss;
+            ss << " --island " << i << " --islands " << nbisland;
+            ss << " --island_topology " << ((topology == IslandTopology::ring) ? "ring" : "random");
+            ss << " --island_interval " << interval << " --island_migrants " << nbmigrant;
+            ss << " --island_timeout " << timeout_ms << " --island_seed " << seed;
+            ss << " --island_dir \"" << dir << "\"";
+            if (!selection.empty())
+            {
+                ss << " --island_selection ";
+                for (size_t k = 0; k < selection.size(); k++) ss << ((k > 0) ? "," : "") << selection[k];
+            }
+            return ss.str();
+        }
+
+        // from_args() - parse main() arguments, unknown ones are ignored
+        static IslandConfig from_args(int argc, char* argv[])
+        {
+            IslandConfig cfg;
+            for (int i = 1; i + 1 < argc; i++)
+            {
+                std::string a = argv[i];
+                std::string v = argv[i + 1];
+                if      (a == "--island")           cfg.island = std::stoi(v);
+                else if (a == "--islands")          cfg.nbisland = std::stoi(v);
+                else if (a == "--island_topology")  cfg.topology = (v == "random") ? IslandTopology::random : IslandTopology::ring;
+                else if (a == "--island_interval")  cfg.interval = std::max(1, std::stoi(v));
+                else if (a == "--island_migrants")  cfg.nbmigrant = std::max(0, std::stoi(v));
+                else if (a == "--island_timeout")   cfg.timeout_ms = std::stoi(v);
+                else if (a == "--island_numa")      cfg.numa_nodes = std::stoi(v);
+                else if (a == "--island_seed")      cfg.seed = std::stoull(v);
+                else if (a == "--island_dir")       cfg.dir = v;
+                else if (a == "--island_selection")
+                {
+                    std::stringstream ss(v);
+                    std::string s;
+                    while (std::getline(ss, s, ',')) if (!s.empty()) cfg.selection.push_back(s);
+                }
+                else continue;
+                i++;
+            }
+            return cfg;
+        }
+    };
+
+    // island_selection() - selection method by name, nullptr if unknown
+    template <typename T, int PARAM_NBIT>
+    void (*island_selection(const std::string& name))(Population<T, PARAM_NBIT>&)
+    {
+        if (name == "RWS") return chess::ga::RWS;
+        if (name == "SUS") return chess::ga::SUS;
+        if (name == "RNK") return chess::ga::RNK;
+        if (name == "RSP") return chess::ga::RSP;
+        if (name == "TNT") return chess::ga::TNT;
+        if (name == "TRS") return chess::ga::TRS;
+        return nullptr;
+    }
+
+    // IslandChannel
+    //  File layout: "ALIM" | uint32 version | uint32 nword | uint32 count | uint64 words[count * nword]
+    class IslandChannel
+    {
+        static const uint32_t VERSION = 1;
+
+    public:
+        IslandChannel(const IslandConfig& cfg, uint64_t ga_id) : _cfg(cfg), _ga_id(ga_id) {}
+
+        std::string file_name(int src, int dst, int norun, int nogen) const
+        {
+            std::stringstream ss;
+            ss << _cfg.dir << "/island_" << _cfg.seed << "_" << _ga_id << "_" << norun << "_" << nogen << "_" << src << "_" << dst << ".mig";
+            return ss.str();
+        }
+
+        // send() - write aside then rename, the receiver never sees a partial file
+        bool send(int dst, int norun, int nogen, const std::vector<std::vector<uint64_t>>& migrants) const
+        {
+            std::string f = file_name(_cfg.island, dst, norun, nogen);
+            std::string ftmp = f + ".tmp";
+            {
+                std::ofstream os;
+                os.open(ftmp.c_str(), std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+                if (!os.good()) return false;
+
+                uint32_t version = VERSION;
+                uint32_t nword = migrants.empty() ? 0 : (uint32_t)migrants[0].size();
+                uint32_t count = (uint32_t)migrants.size();
+                os.write("ALIM", 4);
+                os.write((const char*)&version, sizeof(uint32_t));
+                os.write((const char*)&nword, sizeof(uint32_t));
+                os.write((const char*)&count, sizeof(uint32_t));
+                for (auto& m : migrants) os.write((const char*)m.data(), nword * sizeof(uint64_t));
+
+                bool ok = !os.bad();
+                os.close();
+                if (!ok)
+                {
+                    std::remove(ftmp.c_str());
+                    return false;
+                }
+            }
+            std::remove(f.c_str());
+            return (std::rename(ftmp.c_str(), f.c_str()) == 0);
+        }
+
+        // receive() - wait on the migrants of island src (up to timeout_ms), append them to ret_migrants
+        bool receive(int src, int norun, int nogen, std::vector<std::vector<uint64_t>>& ret_migrants) const
+        {
+            std::string f = file_name(src, _cfg.island, norun, nogen);
+            auto start = std::chrono::steady_clock::now();
+            while (true)
+            {
+                std::ifstream is;
+                is.open(f.c_str(), std::ifstream::in | std::ifstream::binary);
+                if (is.good())
+                {
+                    bool ok = read(is, ret_migrants);
+                    is.close();
+                    std::remove(f.c_str());
+                    return ok;
+                }
+                auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+                if (elapsed >= _cfg.timeout_ms) return false;
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+
+    protected:
+        const IslandConfig& _cfg;
+        uint64_t            _ga_id;
+
+        static bool read(std::ifstream& is, std::vector<std::vector<uint64_t>>& ret_migrants)
+        {
+            char magic[4];
+            uint32_t version, nword, count;
+            is.read(magic, 4);
+            is.read((char*)&version, sizeof(uint32_t));
+            is.read((char*)&nword, sizeof(uint32_t));
+            is.read((char*)&count, sizeof(uint32_t));
+            if (!is.good() || (std::memcmp(magic, "ALIM", 4) != 0) || (version != VERSION)) return false;
+
+            for (uint32_t i = 0; i < count; i++)
+            {
+                std::vector<uint64_t> m(nword);
+                is.read((char*)m.data(), nword * sizeof(uint64_t));
+                if (!is.good()) return false;
+                ret_migrants.push_back(std::move(m));
+            }
+            return true;
+        }
+    };
+
+    // run_islands() - launch command + island arguments for each island on the local host, wait for all of them
+    //                 returns 0 if all islands returned 0
+    inline int run_islands(const std::string& command, const IslandConfig& cfg)
+    {
+        std::vector<std::future<int>> v;
+        for (int i = 0; i < cfg.nbisland; i++)
+        {
+            std::stringstream ss;
+            if (cfg.numa_nodes > 0)
+            {
+#ifdef _WIN32
+                ss << "start \"\" /b /wait /node " << (i % cfg.numa_nodes) << " ";
+#else
+                ss << "numactl --cpunodebind=" << (i % cfg.numa_nodes) << " --membind=" << (i % cfg.numa_nodes) << " ";
+#endif
+            }
+            ss << "\"" << command << "\"" << cfg.args(i);
+            std::string cmd = ss.str();
+            v.push_back(std::async(std::launch::async, [cmd]() { return std::system(cmd.c_str()); }));
+        }
+
+        int ret = 0;
+        for (auto& f : v)
+        {
+            int r = f.get();
+            if (r != 0) ret = r;
+        }
+        return ret;
+    }
+}
+
+#endif
@@ -22,9 +22,9 @@ namespace galgo
     {
     public:
        virtual ~BaseParameter() {}
-       virtual std::string encode() const = 0;
-       virtual std::string encode(T z) const = 0;
-       virtual T decode(const std::string& y) const = 0;
+       virtual uint64_t encode() const = 0;
+       virtual uint64_t encode(T z) const = 0;
+       virtual T decode(uint64_t y) const = 0;
        virtual int size() const = 0;
        virtual const std::vector<T>& getData() const = 0;
     };
@@ -58,20 +58,17 @@ namespace galgo
           return data;
        }
     private:
-       // encoding random unsigned integer
-       std::string encode() const override {
-          std::string str = GetBinary(galgo::Randomize<NBIT>::uniform_uint64());
-          return str.substr(str.size() - NBIT, NBIT);
+       // encoding random unsigned integer (the size() low bits of the gene)
+       uint64_t encode() const override {
+          return galgo::Randomize<NBIT>::uniform_uint64();
        }
        // encoding known unsigned integer
-       std::string encode(T z) const override {
-          uint64_t value = (uint64_t )(Randomize<NBIT>::MAXVAL * (z - data[0]) / (data[1] - data[0]));
-          std::string str = GetBinary(value);
-          return str.substr(str.size() - NBIT, NBIT);
+       uint64_t encode(T z) const override {
+          return (uint64_t )(Randomize<NBIT>::MAXVAL * (z - data[0]) / (data[1] - data[0]));
        }
-       // decoding string to real value
-       T decode(const std::string& str) const override {
-          return data[0] + (GetValue(str) / static_cast<double>(Randomize<NBIT>::MAXVAL)) * (data[1] - data[0]);
+       // decoding gene bits to real value
+       T decode(uint64_t y) const override {
+          return data[0] + (y / static_cast<double>(Randomize<NBIT>::MAXVAL)) * (data[1] - data[0]);
        }
     };
 
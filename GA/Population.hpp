@@ -23,6 +23,9 @@ namespace galgo
 
        void creation(bool init_all_first = false, bool eval_on_creation = true);   // create a population of chromosomes
        void evolution();                            // evolve population, get next generation
+       void immigration(const std::vector<std::vector<uint64_t>>& migrants); // replace worst chromosomes by migrants (packed bits)
+       void write(std::ostream& os) const;          // binary state of current population (Ex: GA checkpoint)
+       bool read(std::istream& is);
 
        // access element in current population at position pos
        const CHR<T, PARAM_NBIT>& operator()(int pos) const;
@@ -99,16 +102,16 @@ namespace galgo
            // initializing first chromosome
            if (!ptr->initialSet.empty()) 
            {
+               chess::RngScope rng_scope(ptr->rng_stream(chess::RngStreamId::ga_creation, 0));
                curpop[0] = std::make_shared<Chromosome<T, PARAM_NBIT>>(*ptr);
                curpop[0]->initialize();
-               if (eval_on_creation) curpop[0]->evaluate(true);
                start++;
            }
            for (int i = start; i < ptr->popsize; ++i)
            {
+               chess::RngScope rng_scope(ptr->rng_stream(chess::RngStreamId::ga_creation, i));
                curpop[i] = std::make_shared<Chromosome<T, PARAM_NBIT>>(*ptr);
                curpop[i]->create();
-               if (eval_on_creation) curpop[i]->evaluate(true);
            }
        }
        else
@@ -117,31 +120,26 @@ namespace galgo
            {
                for (int i = 0; i < ptr->popsize; ++i)
                {
+                   chess::RngScope rng_scope(ptr->rng_stream(chess::RngStreamId::ga_creation, i));
                    curpop[i] = std::make_shared<Chromosome<T, PARAM_NBIT>>(*ptr);
                    curpop[i]->initialize();
-                   if (eval_on_creation) curpop[i]->evaluate(true);
                }
            }
            else
            {
                for (int i = 0; i < ptr->popsize; ++i)
                {
+                   chess::RngScope rng_scope(ptr->rng_stream(chess::RngStreamId::ga_creation, i));
                    curpop[i] = std::make_shared<Chromosome<T, PARAM_NBIT>>(*ptr);
                    curpop[i]->create();
-                   if (eval_on_creation) curpop[i]->evaluate(true);
                }
            }
        }
 
-       if (eval_on_creation == false)
-       {
-           std::cout << "INIT evaluate() start " << std::endl;
-           for (int i = 0; i < ptr->popsize; ++i)
-           {
-               curpop[i]->evaluate(true);
-           }
-           std::cout << "INIT evaluate() done " << std::endl;
-       }
+       // evaluating all chromosomes once created (GA may evaluate them concurrently)
+       if (eval_on_creation == false) std::cout << "INIT evaluate() start " << std::endl;
+       ptr->evaluate_batch(curpop, 0, ptr->popsize, true);
+       if (eval_on_creation == false) std::cout << "INIT evaluate() done " << std::endl;
 
        // updating population
        this->updating();
@@ -154,7 +152,10 @@ namespace galgo
        // initializing mating population index
        matidx = 0;
        // selecting mating population
-       ptr->Selection(*this);
+       {
+           chess::RngScope rng_scope(ptr->rng_stream(chess::RngStreamId::ga_selection));
+           ptr->Selection(*this);
+       }
        // applying elitism if required
        this->elitism(); 
        // crossing-over mating population
@@ -167,6 +168,50 @@ namespace galgo
        this->updating(); 
     }
 
+    // replace worst chromosomes by migrants, elit chromosomes are kept
+    template <typename T, int PARAM_NBIT>
+    void Population<T, PARAM_NBIT>::immigration(const std::vector<std::vector<uint64_t>>& migrants)
+    {
+       int nbword = (ptr->nbbit + 63) / 64;
+       int n = 0;
+       for (const auto& m : migrants) {
+          if (n >= ptr->popsize - ptr->elitpop) break;
+          // ignoring migrants of another chromosome layout
+          if ((int)m.size() != nbword) continue;
+          int i = ptr->popsize - 1 - n;
+          curpop[i] = std::make_shared<Chromosome<T, PARAM_NBIT>>(*ptr);
+          curpop[i]->setWords(m);
+          n++;
+       }
+       if (n == 0) return;
+
+       // evaluating migrants in this island
+       ptr->evaluate_batch(curpop, ptr->popsize - n, ptr->popsize, false);
+       // updating population
+       this->updating();
+    }
+
+    // write current population
+    template <typename T, int PARAM_NBIT>
+    void Population<T, PARAM_NBIT>::write(std::ostream& os) const
+    {
+       write_pod(os, (int32_t)curpop.size());
+       for (const auto& chr : curpop) chr->write(os);
+    }
+
+    // read current population, in the same order (best to worst)
+    template <typename T, int PARAM_NBIT>
+    bool Population<T, PARAM_NBIT>::read(std::istream& is)
+    {
+       int32_t n;
+       if (!read_pod(is, n) || (n != ptr->popsize)) return false;
+       for (int i = 0; i < n; i++) {
+          curpop[i] = std::make_shared<Chromosome<T, PARAM_NBIT>>(*ptr);
+          if (!curpop[i]->read(is)) return false;
+       }
+       return true;
+    }
+
     // elitism => saving best chromosomes in new population, making a copy of each elit chromosome
     template <typename T, int PARAM_NBIT>
     void Population<T, PARAM_NBIT>::elitism()
@@ -189,6 +234,8 @@ namespace galgo
        #pragma omp parallel for num_threads(MAX_THREADS)
        #endif
        for (int i = ptr->elitpop; i < nbrcrov; i = i + 2) {      
+          // own random stream per pair: same draws whatever the thread
+          chess::RngScope rng_scope(ptr->rng_stream(chess::RngStreamId::ga_crossover, i));
           // initializing 2 new chromosome
           newpop[i] = std::make_shared<Chromosome<T, PARAM_NBIT>>(*ptr);
           newpop[i+1] = std::make_shared<Chromosome<T, PARAM_NBIT>>(*ptr);
@@ -197,10 +244,9 @@ namespace galgo
           // mutating new chromosomes
           ptr->Mutation(newpop[i]);   
           ptr->Mutation(newpop[i+1]);   
-          // evaluating new chromosomes
-          newpop[i]->evaluate(false);
-          newpop[i + 1]->evaluate(false);
        } 
+       // evaluating new chromosomes
+       if (ptr->elitpop < nbrcrov) ptr->evaluate_batch(newpop, ptr->elitpop, nbrcrov, false);
     }
 
     // complete new population
@@ -211,13 +257,14 @@ namespace galgo
        #pragma omp parallel for num_threads(MAX_THREADS)
        #endif
        for (int i = nbrcrov; i < ptr->popsize; ++i) {
+          chess::RngScope rng_scope(ptr->rng_stream(chess::RngStreamId::ga_completion, i));
           // selecting chromosome randomly from mating population
           newpop[i] = std::make_shared<Chromosome<T, PARAM_NBIT>>(*matpop[uniform<int>(0, ptr->matsize)]);
           // mutating chromosome
           ptr->Mutation(newpop[i]);
-          // evaluating chromosome
-          newpop[i]->evaluate(false);
        }
+       // evaluating chromosomes
+       if (nbrcrov < ptr->popsize) ptr->evaluate_batch(newpop, nbrcrov, ptr->popsize, false);
     }
 
     // update population (adapting, sorting)
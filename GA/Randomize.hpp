@@ -6,22 +6,25 @@
 //
 //  Randomize<NBIT>::uniform_uint64()   : random uint64 on [0,pow2n(NBIT)]
 //  T uniform<T>(T min, T max)          : random T on [min, max)
+//  double proba()                      : random probability on [0,1)
 //
+//  All draw from chess::thread_rng(), the stream bound by the caller (Ex: Population binds one per chromosome)
 //
 #ifndef _AL_CHESS_GA_RANDOMIZE_H
 #define _AL_CHESS_GA_RANDOMIZE_H
 
 namespace galgo 
 {
-    std::random_device  rnd_dev;                    // uniformly - distributed integer random number generator
-    std::mt19937_64     rnd_generator(rnd_dev());   // Mersenne Twister 19937 pseudo-random number generator [0, pow(2,64))
-    std::uniform_real_distribution<double> uniform_double(0, 1);    // uniform random probability in range [0,1)          
+    inline double proba()
+    {
+        return chess::thread_rng().uniform_double();
+    }
 
     template <typename T>
     inline T uniform(T min, T max)
     {   
         assert(max >= min);
-        return (T)(min + uniform_double(rnd_generator) * (max - min));
+        return chess::thread_rng().uniform<T>(min, max);
     }
 
     template <int NBIT>
@@ -33,8 +36,7 @@ namespace galgo
         static constexpr uint64_t MAXVAL = chess::ga::pow2n(NBIT);
         static uint64_t uniform_uint64() // random uint64 on [0,MAXVAL]
         {
-            static std::uniform_int_distribution<uint64_t> udistrib(0,MAXVAL);
-            return udistrib(rnd_generator);
+            return chess::thread_rng().below(MAXVAL + 1);
         }
     };
 }
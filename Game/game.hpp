@@ -60,6 +60,13 @@ namespace chess
         bool save_ss() const;
         const std::string ss() const { return _ss.str(); }
 
+        // search statistics of last play()
+        const std::vector<SearchStats>& move_stats() const { return _move_stats; }
+        const SearchStats&  game_stats(PieceColor c) const { return (c == PieceColor::W) ? _game_statsW : _game_statsB; }
+        std::string         stats_csv() const;
+        std::string         stats_json() const;
+        bool                save_stats(bool json) const;
+
         void reset_game();
 
    protected:
@@ -75,6 +82,9 @@ namespace chess
         size_t                  _ply = 0;
         mutable size_t          _saved_index;
         std::stringstream       _ss;
+        std::vector<SearchStats> _move_stats;       // one per move played (W and B alternating from _initial_color)
+        SearchStats             _game_statsW;
+        SearchStats             _game_statsB;
     };
 
     // BaseGame()
@@ -95,6 +105,9 @@ namespace chess
         _saved_index = 0;
         _ss.clear();
         _ss = std::stringstream();
+        _move_stats.clear();
+        _game_statsW.clear();
+        _game_statsB.clear();
     }
 
     // play()
@@ -136,6 +149,9 @@ namespace chess
             if (board.get_color() == PieceColor::W) move_idx = _playerW.select_move_algo(board, m, _config._w_max_num_position_per_move, _config._max_num_position, _config._w_max_depth_per_move, _config._max_game_ply, _num_pos_eval, verbose, _ss);
             else                                    move_idx = _playerB.select_move_algo(board, m, _config._b_max_num_position_per_move, _config._max_num_position, _config._b_max_depth_per_move, _config._max_game_ply, _num_pos_eval, verbose, _ss);
 
+            if (board.get_color() == PieceColor::W) { _move_stats.push_back(_playerW.search_stats()); _game_statsW.add(_playerW.search_stats()); }
+            else                                    { _move_stats.push_back(_playerB.search_stats()); _game_statsB.add(_playerB.search_stats()); }
+
             assert(move_idx < m.size());
             board.apply_move(m[move_idx]);
 
@@ -188,6 +204,56 @@ namespace chess
         os.close();
         return false;
     }
+
+    // stats_csv() - one row per move
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    inline std::string BaseGame<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::stats_csv() const
+    {
+        std::stringstream ss;
+        PieceColor c = _initial_color;
+        ss << "move,color," << SearchStats::csv_header() << std::endl;
+        for (size_t i = 0; i < _move_stats.size(); i++)
+        {
+            ss << i << "," << ((c == PieceColor::W) ? "W" : "B") << "," << _move_stats[i].to_csv() << std::endl;
+            c = (c == PieceColor::W) ? PieceColor::B : PieceColor::W;
+        }
+        return ss.str();
+    }
+
+    // stats_json() - game totals per color and per move detail
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    inline std::string BaseGame<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::stats_json() const
+    {
+        std::stringstream ss;
+        ss << "{\"score\":" << ExactScore_to_int(_score) << ",\"ply\":" << _ply << ",\"num_pos_eval\":" << _num_pos_eval;
+        ss << ",\"W\":" << _game_statsW.to_json() << ",\"B\":" << _game_statsB.to_json();
+        ss << ",\"moves\":[";
+        for (size_t i = 0; i < _move_stats.size(); i++)
+        {
+            if (i > 0) ss << ",";
+            ss << _move_stats[i].to_json();
+        }
+        ss << "]}";
+        return ss.str();
+    }
+
+    // save_stats()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    inline bool BaseGame<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::save_stats(bool json) const
+    {
+        std::string f = PersistManager<PieceID, _BoardSize>::instance()->get_stream_name("gamestats", std::to_string(_saved_index) + (json ? "_json" : "_csv"));
+        std::ofstream os;
+        os.open(f.c_str(), std::ofstream::out | std::ofstream::trunc);
+        if (os.good())
+        {
+            if (json)   os << stats_json() << std::endl;
+            else        os << stats_csv();
+            os.close();
+            return true;
+        }
+        os.close();
+        return false;
+    }
 };
 
 #endif
@@ -0,0 +1,252 @@
+#pragma once
+//=================================================================================================
+//                    Copyright (C) 2017 Alain Lanthier - All Rights Reserved                      
+//=================================================================================================
+//
+// GameBatch<>      : many games in flight on a TaskPool, results in a compact buffer
+//
+// The games of a batch are queued at once on the pool workers. Each worker owns clones of the players
+// of every pairing (a pairing is a W player and a B player), made at the first run() and reused by all
+// later batches: a game costs no thread, no BaseGame and no player copy. Game slots (initial position,
+// move list) are reused from batch to batch, a game only keeps its moves (4 bytes each), score and timing.
+// A game is played as BaseGame::play() without verbose output, save or per move search statistics.
+//
+#ifndef _AL_CHESS_GAME_GAMEBATCH_HPP
+#define _AL_CHESS_GAME_GAMEBATCH_HPP
+
+namespace chess
+{
+    // GameBatchMove - squares of a move (notation of Move<>::to_str())
+    struct GameBatchMove
+    {
+        uint8_t src_x;
+        uint8_t src_y;
+        uint8_t dst_x;
+        uint8_t dst_y;
+
+        std::string to_str() const
+        {
+            return std::to_string((int)src_x) + std::to_string((int)src_y) + std::to_string((int)dst_x) + std::to_string((int)dst_y);
+        }
+    };
+
+    // GameBatchResult - moves of game i are moves()[_move_begin, _move_begin + _ply)
+    struct GameBatchResult
+    {
+        ExactScore  _score = ExactScore::UNKNOWN;
+        uint16_t    _ply = 0;
+        uint16_t    _pairing = 0;
+        uint32_t    _move_begin = 0;
+        uint32_t    _usec = 0;              // wall time of the game
+        size_t      _num_pos_eval = 0;
+    };
+
+    // play_game_fast() - a game as BaseGame::play() without verbose output, save or per move search statistics
+    //                    board is played in place, on_move(move, board) is called after each move
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT, typename OnMove>
+    ExactScore play_game_fast(  Board<PieceID, _BoardSize>& board,
+                                DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>& playerW,
+                                DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>& playerB,
+                                const BaseGame_Config& cfg, size_t& num_pos_eval, std::stringstream& verbose_stream, OnMove on_move)
+    {
+        std::vector<Move<PieceID>> m;
+        size_t move_idx;
+        while (true)
+        {
+            m = board.generate_moves();
+            if (board.is_final(m))                                  return board.final_score(m);
+            else if (board.get_histo_size() >= cfg._max_game_ply)  return ExactScore::DRAW;
+
+            if (board.get_color() == PieceColor::W) move_idx = playerW.select_move_algo(board, m, cfg._w_max_num_position_per_move, cfg._max_num_position, cfg._w_max_depth_per_move, cfg._max_game_ply, num_pos_eval, 0, verbose_stream);
+            else                                    move_idx = playerB.select_move_algo(board, m, cfg._b_max_num_position_per_move, cfg._max_num_position, cfg._b_max_depth_per_move, cfg._max_game_ply, num_pos_eval, 0, verbose_stream);
+
+            assert(move_idx < m.size());
+            board.apply_move(m[move_idx]);
+            on_move(m[move_idx], board);
+        }
+    }
+
+    // GameBatch
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    class GameBatch
+    {
+        using _Board = Board<PieceID, _BoardSize>;
+        using _Move = Move<PieceID>;
+        using _DomainPlayer = DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+
+        struct Slot
+        {
+            _Board                      _initial_position;
+            size_t                      _pairing = 0;
+            std::vector<GameBatchMove>  _moves;
+        };
+        struct Worker
+        {
+            std::vector<_DomainPlayer*> _players;       // W, B of each pairing
+            std::stringstream           _ss;            // verbose stream of select_move_algo() (unused)
+        };
+
+    public:
+        // before_game(worker, game, W, B) - called by the worker before playing the game (Ex: set the weights of its clones)
+        using BeforeGame = std::function<void(size_t, size_t, _DomainPlayer&, _DomainPlayer&)>;
+
+        // GameBatch() - games played by the pool workers, nullptr: own pool (one worker per hardware thread)
+        GameBatch(BaseGame_Config cfg, TaskPool* pool = nullptr) : _cfg(cfg), _pool(pool)
+        {
+            if (_pool == nullptr)
+            {
+                _own_pool.reset(new TaskPool());
+                _pool = _own_pool.get();
+            }
+        }
+        ~GameBatch() { delete_workers(); }
+
+        GameBatch(const GameBatch&) = delete;
+        GameBatch & operator=(const GameBatch &) = delete;
+
+        // add_pairing() - returns the pairing index of the games of these players
+        size_t add_pairing(_DomainPlayer* playerW, _DomainPlayer* playerB)
+        {
+            delete_workers();
+            _pairings.push_back(std::make_pair(playerW, playerB));
+            return _pairings.size() - 1;
+        }
+
+        // refresh() - new clones at next run() (the players have changed)
+        void refresh() { delete_workers(); }
+
+        // clear() - no game, buffers kept for the next batch
+        void clear() { _n_game = 0; _results.clear(); _moves.clear(); }
+
+        // add_game() - returns the game index
+        size_t add_game(const _Board& initial_position, size_t pairing = 0)
+        {
+            assert(pairing < _pairings.size());
+            if (_n_game == _slots.size()) _slots.push_back(Slot());
+            _slots[_n_game]._initial_position = initial_position;
+            _slots[_n_game]._pairing = pairing;
+            return _n_game++;
+        }
+
+        void run(const BeforeGame& before_game = nullptr);
+
+        size_t                              nworker() const         { return _pool->size(); }
+        size_t                              size() const            { return _n_game; }
+        const GameBatchResult&              result(size_t i) const  { return _results[i]; }
+        const std::vector<GameBatchResult>& results() const         { return _results; }
+        const std::vector<GameBatchMove>&   moves() const           { return _moves; }
+        std::string                         move_list(size_t i) const;
+
+    protected:
+        BaseGame_Config                     _cfg;
+        TaskPool*                           _pool;
+        std::unique_ptr<TaskPool>           _own_pool;
+        std::vector<std::pair<_DomainPlayer*, _DomainPlayer*>> _pairings;
+        std::vector<Worker*>                _workers;
+        std::vector<Slot>                   _slots;
+        size_t                              _n_game = 0;
+        std::vector<GameBatchResult>        _results;
+        std::vector<GameBatchMove>          _moves;
+
+        void create_workers(size_t n);
+        void delete_workers();
+        void play_game(Worker& w, size_t worker, size_t k, const BeforeGame& before_game);
+    };
+
+    // create_workers()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    void GameBatch<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::create_workers(size_t n)
+    {
+        for (size_t w = 0; w < n; w++)
+        {
+            Worker* worker = new Worker;
+            for (auto& p : _pairings)
+            {
+                worker->_players.push_back(p.first->clone());
+                worker->_players.push_back(p.second->clone());
+            }
+            _workers.push_back(worker);
+        }
+    }
+
+    // delete_workers()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    void GameBatch<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::delete_workers()
+    {
+        for (auto& w : _workers)
+        {
+            for (auto& p : w->_players) delete p;
+            delete w;
+        }
+        _workers.clear();
+    }
+
+    // run() - play all games of the batch, results in game order
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    void GameBatch<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::run(const BeforeGame& before_game)
+    {
+        if (_workers.size() != _pool->size())
+        {
+            delete_workers();
+            create_workers(_pool->size());
+        }
+
+        _results.assign(_n_game, GameBatchResult());
+        _pool->run(_n_game, [&](size_t w, size_t k)
+        {
+            play_game(*_workers[w], w, k, before_game);
+        });
+
+        // compact the move lists
+        size_t n = 0;
+        for (size_t k = 0; k < _n_game; k++) n += _slots[k]._moves.size();
+        _moves.clear();
+        _moves.reserve(n);
+        for (size_t k = 0; k < _n_game; k++)
+        {
+            _results[k]._move_begin = (uint32_t)_moves.size();
+            _moves.insert(_moves.end(), _slots[k]._moves.begin(), _slots[k]._moves.end());
+        }
+    }
+
+    // play_game()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    void GameBatch<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::play_game(Worker& w, size_t worker, size_t k, const BeforeGame& before_game)
+    {
+        Slot& slot = _slots[k];
+        GameBatchResult& r = _results[k];
+        _DomainPlayer& playerW = *w._players[2 * slot._pairing];
+        _DomainPlayer& playerB = *w._players[2 * slot._pairing + 1];
+        if (before_game) before_game(worker, k, playerW, playerB);
+
+        auto start = std::chrono::steady_clock::now();
+        _Board board = slot._initial_position;
+        slot._moves.clear();
+        r._score = play_game_fast(board, playerW, playerB, _cfg, r._num_pos_eval, w._ss, [&slot](const _Move& mv, const _Board&)
+        {
+            slot._moves.push_back(GameBatchMove{ mv.src_x, mv.src_y, mv.dst_x, mv.dst_y });
+        });
+        r._ply = (uint16_t)slot._moves.size();
+        r._pairing = (uint16_t)slot._pairing;
+        r._usec = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // move_list() - "1. 0011 4455 2. ..." (the first move is "1. ... 4455" if B plays first)
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    std::string GameBatch<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::move_list(size_t i) const
+    {
+        std::stringstream ss;
+        const GameBatchResult& r = _results[i];
+        size_t ply = (_slots[i]._initial_position.get_color() == PieceColor::W) ? 0 : 1;
+        if (ply == 1) ss << "1. ...";
+        for (size_t j = 0; j < r._ply; j++, ply++)
+        {
+            if ((ply % 2) == 0) ss << ((ply > 0) ? " " : "") << (ply / 2 + 1) << ".";
+            ss << " " << _moves[r._move_begin + j].to_str();
+        }
+        ss << " " << ((r._score == ExactScore::WIN) ? "1-0" : (r._score == ExactScore::LOSS) ? "0-1" : "1/2-1/2");
+        return ss.str();
+    }
+};
+
+#endif
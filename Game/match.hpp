@@ -0,0 +1,237 @@
+#pragma once
+//=================================================================================================
+//                    Copyright (C) 2017 Alain Lanthier - All Rights Reserved                      
+//=================================================================================================
+//
+// MatchStats       : scores of a match, Elo difference with error bar, SPRT log likelihood ratio
+// MatchManager<>   : candidate players against baseline players, paired games stopped by SPRT (on a GameBatch)
+//
+// A pair is 2 games from the same initial position with colors swapped (candidate W vs baseline B, then
+// baseline W vs candidate B): the position bias cancels out in the pair score (0, 1/4, 1/2, 3/4 or 1).
+// SPRT is the normal approximation of the generalized SPRT on the sample scores (games or pairs):
+//  H0: elo <= elo0, H1: elo >= elo1, alpha: probability to accept H1 when H0 holds, beta: H0 when H1 holds.
+// The normal approximation needs samples: no decision before min_sample samples, and the variance is floored
+// at min_variance (a few identical scores have no spread, their LLR would be infinite).
+//
+#ifndef _AL_CHESS_GAME_MATCH_HPP
+#define _AL_CHESS_GAME_MATCH_HPP
+
+namespace chess
+{
+    struct SprtConfig
+    {
+        double  _elo0 = 0.0;
+        double  _elo1 = 5.0;
+        double  _alpha = 0.05;
+        double  _beta = 0.05;
+        size_t  _min_sample = 16;       // samples before a decision
+        double  _min_variance = 0.01;   // floor of the sample score variance in the LLR
+    };
+
+    enum class SprtResult { none, H0, H1 };
+
+    inline std::string SprtResult_to_string(SprtResult r)
+    {
+        if (r == SprtResult::H0) return "H0";
+        if (r == SprtResult::H1) return "H1";
+        return "none";
+    }
+
+    // MatchStats - samples in 5 buckets of score 0, 1/4, 1/2, 3/4, 1 (a game uses 0, 1/2, 1)
+    class MatchStats
+    {
+    public:
+        void clear() { _count.fill(0); _n_game = 0; }
+
+        // add_game() - score of the candidate (1: win, 0.5: draw, 0: loss)
+        void add_game(double score)
+        {
+            _count[bucket(score)]++;
+            _n_game++;
+        }
+
+        // add_pair() - scores of the candidate in the 2 games of a pair
+        void add_pair(double score1, double score2)
+        {
+            _count[bucket((score1 + score2) / 2.0)]++;
+            _n_game += 2;
+        }
+
+        size_t n_sample()   const { size_t n = 0; for (auto c : _count) n += (size_t)c; return n; }
+        size_t n_game()     const { return _n_game; }
+
+        double mean() const
+        {
+            size_t n = n_sample();
+            if (n == 0) return 0.5;
+            double s = 0;
+            for (size_t i = 0; i < _count.size(); i++) s += (double)_count[i] * score_of(i);
+            return s / (double)n;
+        }
+
+        // variance() - of a sample score
+        double variance() const
+        {
+            size_t n = n_sample();
+            if (n == 0) return 0;
+            double m = mean();
+            double s = 0;
+            for (size_t i = 0; i < _count.size(); i++) s += (double)_count[i] * (score_of(i) - m) * (score_of(i) - m);
+            return s / (double)n;
+        }
+
+        double elo() const { return score_to_elo(mean()); }
+
+        // elo_error95() - half width of the 95% confidence interval of elo()
+        double elo_error95() const
+        {
+            size_t n = n_sample();
+            if (n == 0) return 0;
+            double m = mean();
+            double d = 1.96 * std::sqrt(variance() / (double)n);
+            return (score_to_elo(m + d) - score_to_elo(m - d)) / 2.0;
+        }
+
+        // llr() - log likelihood ratio of H1 (elo1) over H0 (elo0), variance floored at min_variance
+        double llr(double elo0, double elo1, double min_variance = 0) const
+        {
+            size_t n = n_sample();
+            double v = std::max(variance(), min_variance);
+            if ((n == 0) || (v <= 0)) return 0;     // no information on the spread yet
+            double s0 = elo_to_score(elo0);
+            double s1 = elo_to_score(elo1);
+            return (double)n * (s1 - s0) * (2.0 * mean() - s0 - s1) / (2.0 * v);
+        }
+
+        static double lower_bound(const SprtConfig& cfg) { return std::log(cfg._beta / (1.0 - cfg._alpha)); }
+        static double upper_bound(const SprtConfig& cfg) { return std::log((1.0 - cfg._beta) / cfg._alpha); }
+
+        double llr(const SprtConfig& cfg) const { return llr(cfg._elo0, cfg._elo1, cfg._min_variance); }
+
+        SprtResult sprt(const SprtConfig& cfg) const
+        {
+            if (n_sample() < std::max<size_t>(1, cfg._min_sample)) return SprtResult::none;
+            double r = llr(cfg);
+            if (r >= upper_bound(cfg)) return SprtResult::H1;
+            if (r <= lower_bound(cfg)) return SprtResult::H0;
+            return SprtResult::none;
+        }
+
+        static double elo_to_score(double elo) { return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0)); }
+        static double score_to_elo(double score)
+        {
+            score = std::min(std::max(score, 1e-6), 1.0 - 1e-6);
+            return -400.0 * std::log10(1.0 / score - 1.0);
+        }
+
+        std::string to_string() const
+        {
+            std::stringstream ss;
+            ss << "games: " << _n_game << " samples: " << n_sample();
+            ss << " [" << _count[0] << " " << _count[1] << " " << _count[2] << " " << _count[3] << " " << _count[4] << "]";
+            ss << std::fixed << std::setprecision(1) << " elo: " << elo() << " +/- " << elo_error95();
+            return ss.str();
+        }
+
+    private:
+        std::array<uint64_t, 5> _count{};
+        size_t                  _n_game = 0;
+
+        static size_t bucket(double score)      { return (size_t)std::min(4.0, std::max(0.0, std::floor(score * 4.0 + 0.5))); }
+        static double score_of(size_t bucket)   { return (double)bucket / 4.0; }
+    };
+
+    // MatchManager
+    //  Games are played by a GameBatch: each worker plays with its own clones of the 4 players (made at the first run()),
+    //  the players given are not modified. Child domains are evaluated by the players attached to them (see DomainPlayer::clone()).
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    class MatchManager
+    {
+        using _Board = Board<PieceID, _BoardSize>;
+        using _DomainPlayer = DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _GameBatch = GameBatch<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+
+    public:
+        MatchManager(_DomainPlayer* candW, _DomainPlayer* candB, _DomainPlayer* baseW, _DomainPlayer* baseB, BaseGame_Config cfg, TaskPool* pool = nullptr)
+            : _candW(candW), _batch(cfg, pool)
+        {
+            _batch.add_pairing(candW, baseB);       // pairing 0: candidate W
+            _batch.add_pairing(baseW, candB);       // pairing 1: candidate B
+        }
+
+        MatchManager(const MatchManager&) = delete;
+        MatchManager & operator=(const MatchManager &) = delete;
+
+        // set_positions() - initial positions of the pairs (cycled), W to play
+        void set_positions(const std::vector<_Board>& v)    { _positions = v; }
+
+        // set_random_positions() - n positions of the candidate W domain, same positions for the same seed
+        void set_random_positions(size_t n, uint64_t seed)
+        {
+            RngScope rng_scope(RngMaster::stream(RngStreamId::match).stream(seed));
+            _positions.clear();
+            for (size_t i = 0; i < n; i++)
+                _positions.push_back(_candW->domain()->get_random_position(true));
+        }
+
+        // run() - pairs by batches of batch_pair until SPRT decides or max_pair pairs are played
+        SprtResult run(const SprtConfig& sprt, size_t max_pair, size_t batch_pair = 64, char verbose = 0);
+
+        const MatchStats&   stats() const { return _stats; }
+        const _GameBatch&   last_batch() const { return _batch; }      // games of the last batch (2 per pair)
+
+    protected:
+        _DomainPlayer*          _candW;
+        _GameBatch              _batch;
+        std::vector<_Board>     _positions;
+        MatchStats              _stats;
+
+        // candidate_score() - score of the candidate in a game, an unfinished game is a draw
+        static double candidate_score(ExactScore sc, bool candidate_white)
+        {
+            if (sc == ExactScore::WIN)  return candidate_white ? 1.0 : 0.0;
+            if (sc == ExactScore::LOSS) return candidate_white ? 0.0 : 1.0;
+            return 0.5;
+        }
+    };
+
+    // run()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    SprtResult MatchManager<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::run(const SprtConfig& sprt, size_t max_pair, size_t batch_pair, char verbose)
+    {
+        _stats.clear();
+        if (_positions.empty()) set_random_positions(std::max<size_t>(1, max_pair), 0);
+        batch_pair = std::max<size_t>(1, batch_pair);
+
+        // pair results added in pair order: the decision does not depend on the scheduling
+        SprtResult result = SprtResult::none;
+        size_t next_pair = 0;
+        while ((result == SprtResult::none) && (next_pair < max_pair))
+        {
+            size_t n = std::min(batch_pair, max_pair - next_pair);
+            _batch.clear();
+            for (size_t k = 0; k < n; k++)
+            {
+                const _Board& board = _positions[(next_pair + k) % _positions.size()];
+                _batch.add_game(board, 0);
+                _batch.add_game(board, 1);
+            }
+            _batch.run();
+
+            for (size_t k = 0; k < n; k++)
+                _stats.add_pair(candidate_score(_batch.result(2 * k)._score, true), candidate_score(_batch.result(2 * k + 1)._score, false));
+            next_pair += n;
+            result = _stats.sprt(sprt);
+
+            if (verbose)
+            {
+                std::cout << "Match " << _stats.to_string();
+                std::cout << " LLR: " << std::setprecision(2) << _stats.llr(sprt);
+                std::cout << " [" << MatchStats::lower_bound(sprt) << ", " << MatchStats::upper_bound(sprt) << "]" << std::endl;
+            }
+        }
+        return result;
+    }
+};
+
+#endif
@@ -0,0 +1,426 @@
+#pragma once
+//=================================================================================================
+//                    Copyright (C) 2017 Alain Lanthier - All Rights Reserved                      
+//=================================================================================================
+//
+// SelfPlaySample<>     : a labelled position of the training store
+// SelfPlayStore<>      : training store, binary file of samples (append only)
+// SelfPlayPipeline<>   : games played, labelled and stored by concurrent stages
+//
+// Stages are threads connected by bounded lock free queues (rigtorp::MPMCQueue) of game items:
+//      producers (play games) -> labelers (TB score of each position reached) -> writer (append to the store)
+// Game items are allocated once and recycled through a free queue: a producer waits for a free item and a
+// stage waits when its output queue is full (backpressure), so memory is bounded whatever the stage speeds.
+// A game only depends on (seed, game index), samples are appended in the order games are labelled.
+// The store is read back by FeatureDatasetBuilder (set_store_file()) as the labelled rows of the trainers.
+//
+#ifndef _AL_CHESS_GAME_SELFPLAY_HPP
+#define _AL_CHESS_GAME_SELFPLAY_HPP
+
+#include <ExternLib/MPMCQueue/MPMCQueue.h>
+
+namespace chess
+{
+    // SelfPlaySample
+    template <typename PieceID, typename uint8_t _BoardSize>
+    struct SelfPlaySample
+    {
+        std::array<PieceID, _BoardSize * _BoardSize> _cells;    // piece id of square (x + y * _BoardSize)
+        PieceColor  _color;                 // color to play
+        ExactScore  _tb_score;              // UNKNOWN: position not in a domain with known scores
+        ExactScore  _game_score;            // result of the game
+        uint16_t    _ply;                   // ply of the position in its game
+        uint32_t    _game;                  // game index in the run
+
+        // from_board() - cells and color to play of b
+        void from_board(const Board<PieceID, _BoardSize>& b)
+        {
+            for (uint8_t y = 0; y < _BoardSize; y++)
+                for (uint8_t x = 0; x < _BoardSize; x++)
+                    _cells[x + y * _BoardSize] = b.get_pieceid_at(x, y);
+            _color = b.get_color();
+        }
+
+        // to_board() - position of the sample (no move history)
+        void to_board(Board<PieceID, _BoardSize>& ret_board) const
+        {
+            ret_board.clear();
+            for (uint8_t y = 0; y < _BoardSize; y++)
+                for (uint8_t x = 0; x < _BoardSize; x++)
+                    ret_board.set_pieceid_at(_cells[x + y * _BoardSize], x, y);
+            ret_board.set_color(_color);
+        }
+    };
+
+    // SelfPlayStore
+    //  File layout: "ALSP" | uint32 version | uint32 board size | uint32 sizeof(PieceID) | records
+    //  record: PieceID cells[_BoardSize * _BoardSize] | int8 color | int8 tb score | int8 game score | uint16 ply | uint32 game
+    template <typename PieceID, typename uint8_t _BoardSize>
+    class SelfPlayStore
+    {
+        using _Sample = SelfPlaySample<PieceID, _BoardSize>;
+        static const uint32_t VERSION = 1;
+
+    public:
+        SelfPlayStore() {}
+        ~SelfPlayStore() { close(); }
+
+        SelfPlayStore(const SelfPlayStore&) = delete;
+        SelfPlayStore & operator=(const SelfPlayStore &) = delete;
+
+        // open() - append to filename, a new file gets the header, a file of another format is refused
+        bool open(const std::string& filename)
+        {
+            close();
+            {
+                std::ifstream is;
+                is.open(filename.c_str(), std::ifstream::in | std::ifstream::binary);
+                if (is.good() && (is.peek() != std::ifstream::traits_type::eof()))
+                {
+                    bool ok = read_header(is);
+                    is.close();
+                    if (!ok) return false;
+                    _os.open(filename.c_str(), std::ofstream::out | std::ofstream::app | std::ofstream::binary);
+                    return _os.good();
+                }
+            }
+
+            _os.open(filename.c_str(), std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+            if (!_os.good()) return false;
+            uint32_t version = VERSION;
+            uint32_t board_size = _BoardSize;
+            uint32_t id_size = sizeof(PieceID);
+            _os.write("ALSP", 4);
+            _os.write((const char*)&version, sizeof(uint32_t));
+            _os.write((const char*)&board_size, sizeof(uint32_t));
+            _os.write((const char*)&id_size, sizeof(uint32_t));
+            return _os.good();
+        }
+
+        bool append(const _Sample& s)
+        {
+            int8_t color = (int8_t)PieceColor_to_int(s._color);
+            int8_t tb_score = (int8_t)ExactScore_to_int(s._tb_score);
+            int8_t game_score = (int8_t)ExactScore_to_int(s._game_score);
+            _os.write((const char*)s._cells.data(), s._cells.size() * sizeof(PieceID));
+            _os.write((const char*)&color, 1);
+            _os.write((const char*)&tb_score, 1);
+            _os.write((const char*)&game_score, 1);
+            _os.write((const char*)&s._ply, sizeof(uint16_t));
+            _os.write((const char*)&s._game, sizeof(uint32_t));
+            if (!_os.good()) return false;
+            _count++;
+            return true;
+        }
+
+        void close()
+        {
+            if (_os.is_open()) _os.close();
+            _count = 0;
+        }
+
+        size_t count() const { return _count; }     // samples appended since open()
+
+        // read() - all samples of filename
+        static bool read(const std::string& filename, std::vector<_Sample>& ret_samples)
+        {
+            std::ifstream is;
+            is.open(filename.c_str(), std::ifstream::in | std::ifstream::binary);
+            if (!is.good() || !read_header(is)) return false;
+
+            _Sample s;
+            int8_t color, tb_score, game_score;
+            while (is.read((char*)s._cells.data(), s._cells.size() * sizeof(PieceID)))
+            {
+                is.read((char*)&color, 1);
+                is.read((char*)&tb_score, 1);
+                is.read((char*)&game_score, 1);
+                is.read((char*)&s._ply, sizeof(uint16_t));
+                is.read((char*)&s._game, sizeof(uint32_t));
+                if (!is.good()) return false;
+                s._color = int_to_PieceColor(color);
+                s._tb_score = int_to_ExactScore(tb_score);
+                s._game_score = int_to_ExactScore(game_score);
+                ret_samples.push_back(s);
+            }
+            return true;
+        }
+
+    protected:
+        std::ofstream   _os;
+        size_t          _count = 0;
+
+        static bool read_header(std::ifstream& is)
+        {
+            char magic[4];
+            uint32_t version, board_size, id_size;
+            is.read(magic, 4);
+            is.read((char*)&version, sizeof(uint32_t));
+            is.read((char*)&board_size, sizeof(uint32_t));
+            is.read((char*)&id_size, sizeof(uint32_t));
+            return is.good() && (std::memcmp(magic, "ALSP", 4) == 0) && (version == VERSION) &&
+                   (board_size == _BoardSize) && (id_size == sizeof(PieceID));
+        }
+    };
+
+    struct SelfPlayConfig
+    {
+        size_t      _n_producer = 0;            // game threads, 0: hardware threads left by the labelers and the writer
+        size_t      _n_labeler = 1;
+        size_t      _queue_capacity = 64;       // games per queue
+        bool        _keep_unknown = false;      // also store positions without a known score
+        uint64_t    _seed = 0;                  // games stream (initial positions and players draws)
+    };
+
+    struct SelfPlayStats
+    {
+        size_t      _games = 0;
+        size_t      _positions = 0;
+        size_t      _labelled = 0;              // positions with a known score
+        size_t      _written = 0;
+        size_t      _producer_waits = 0;        // games held by a full queue (backpressure of the labelers)
+        size_t      _labeler_waits = 0;         // games held by a full queue (backpressure of the writer)
+    };
+
+    // SelfPlayPipeline
+    //  Each producer plays with its own clones of the players (made by run()), the players given are not modified.
+    //  Child domains are evaluated by the players attached to them (see DomainPlayer::clone()).
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    class SelfPlayPipeline
+    {
+        using _Board = Board<PieceID, _BoardSize>;
+        using _Move = Move<PieceID>;
+        using _Domain = Domain<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _DomainPlayer = DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _SelfPlayStore = SelfPlayStore<PieceID, _BoardSize>;
+        using _Sample = SelfPlaySample<PieceID, _BoardSize>;
+
+        // GameItem - positions [0, _n) of a game: initial position, then after each move
+        struct GameItem
+        {
+            uint32_t                _game = 0;
+            ExactScore              _score = ExactScore::UNKNOWN;
+            size_t                  _n = 0;
+            std::vector<_Board>     _positions;     // capacity kept when recycled
+            std::vector<ExactScore> _labels;
+
+            void add(const _Board& board)
+            {
+                if (_n < _positions.size()) _positions[_n] = board;
+                else                        _positions.push_back(board);
+                _n++;
+            }
+        };
+        using _Queue = rigtorp::MPMCQueue<GameItem*>;
+
+    public:
+        SelfPlayPipeline(_DomainPlayer* playerW, _DomainPlayer* playerB, BaseGame_Config cfg, const SelfPlayConfig& spcfg = SelfPlayConfig())
+            : _playerW(playerW), _playerB(playerB), _cfg(cfg), _spcfg(spcfg)
+        {
+        }
+
+        // run() - play n_game games, their labelled positions appended to the store file
+        bool run(size_t n_game, const std::string& store_file);
+
+        SelfPlayStats stats() const
+        {
+            SelfPlayStats s;
+            s._games = _games;
+            s._positions = _positions;
+            s._labelled = _labelled;
+            s._written = _written;
+            s._producer_waits = _producer_waits;
+            s._labeler_waits = _labeler_waits;
+            return s;
+        }
+
+        // tb_score() - known score of the position in the domain or a child domain (UNKNOWN if none)
+        static ExactScore tb_score(const _Domain* domain, _Board& board)
+        {
+            const _Domain* d = nullptr;
+            if (domain->isInDomain(board)) d = domain;
+            for (size_t i = 0; (d == nullptr) && (i < domain->children().size()); i++)
+                if (domain->children()[i]->isInDomain(board)) d = domain->children()[i];
+            if ((d == nullptr) || !d->has_known_score_move()) return ExactScore::UNKNOWN;
+
+            std::vector<_Move> m = board.generate_moves();
+            size_t ret_mv_idx;
+            return d->get_known_score_move(board, m, ret_mv_idx);
+        }
+
+    protected:
+        _DomainPlayer*          _playerW;
+        _DomainPlayer*          _playerB;
+        BaseGame_Config         _cfg;
+        SelfPlayConfig          _spcfg;
+
+        std::atomic<size_t>     _next_game{ 0 };
+        std::atomic<size_t>     _games{ 0 };
+        std::atomic<size_t>     _positions{ 0 };
+        std::atomic<size_t>     _labelled{ 0 };
+        std::atomic<size_t>     _written{ 0 };
+        std::atomic<size_t>     _producer_waits{ 0 };
+        std::atomic<size_t>     _labeler_waits{ 0 };
+
+        void produce(_DomainPlayer* playerW, _DomainPlayer* playerB, size_t n_game, _Queue& free_queue, _Queue& played_queue);
+        void label(_Queue& played_queue, _Queue& labelled_queue);
+        void write(_Queue& labelled_queue, _Queue& free_queue, _SelfPlayStore& store);
+
+        // push_wait() - push, waiting while the queue is full
+        static void push_wait(_Queue& q, GameItem* item, std::atomic<size_t>* waits)
+        {
+            if (q.try_push(item)) return;
+            if (waits != nullptr) (*waits)++;
+            for (size_t i = 0; !q.try_push(item); i++) backoff(i);
+        }
+
+        // pop_wait() - pop, waiting while the queue is empty
+        static GameItem* pop_wait(_Queue& q)
+        {
+            GameItem* item;
+            for (size_t i = 0; !q.try_pop(item); i++) backoff(i);
+            return item;
+        }
+
+        // backoff() - spin a little then sleep, an idle stage leaves its core to the others
+        static void backoff(size_t i)
+        {
+            if (i < 64) std::this_thread::yield();
+            else        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    };
+
+    // run()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    bool SelfPlayPipeline<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::run(size_t n_game, const std::string& store_file)
+    {
+        _SelfPlayStore store;
+        if (!store.open(store_file)) return false;
+
+        size_t n_labeler = std::max<size_t>(1, _spcfg._n_labeler);
+        size_t n_producer = _spcfg._n_producer;
+        if (n_producer == 0)
+        {
+            size_t n_thread = std::thread::hardware_concurrency();
+            n_producer = (n_thread > n_labeler + 1) ? n_thread - n_labeler - 1 : 1;
+        }
+        size_t capacity = std::max<size_t>(1, _spcfg._queue_capacity);
+
+        // every item is in a queue or held by a stage thread
+        size_t n_item = 2 * capacity + n_producer + n_labeler + 1;
+        std::vector<std::unique_ptr<GameItem>> items;
+        _Queue free_queue(n_item);
+        _Queue played_queue(capacity);
+        _Queue labelled_queue(capacity);
+        for (size_t i = 0; i < n_item; i++)
+        {
+            items.push_back(std::unique_ptr<GameItem>(new GameItem));
+            free_queue.push(items.back().get());
+        }
+
+        std::vector<std::unique_ptr<_DomainPlayer>> clones;
+        for (size_t p = 0; p < n_producer; p++)
+        {
+            clones.push_back(std::unique_ptr<_DomainPlayer>(_playerW->clone()));
+            clones.push_back(std::unique_ptr<_DomainPlayer>(_playerB->clone()));
+        }
+
+        _next_game = 0;
+        _games = 0; _positions = 0; _labelled = 0; _written = 0; _producer_waits = 0; _labeler_waits = 0;
+
+        std::thread writer([&]() { write(labelled_queue, free_queue, store); });
+        std::vector<std::thread> labelers;
+        for (size_t l = 0; l < n_labeler; l++)
+            labelers.push_back(std::thread([&]() { label(played_queue, labelled_queue); }));
+        std::vector<std::thread> producers;
+        for (size_t p = 0; p < n_producer; p++)
+        {
+            _DomainPlayer* playerW = clones[2 * p].get();
+            _DomainPlayer* playerB = clones[2 * p + 1].get();
+            producers.push_back(std::thread([&, playerW, playerB]() { produce(playerW, playerB, n_game, free_queue, played_queue); }));
+        }
+
+        // shutdown in stage order: a nullptr item ends a labeler, then the writer
+        for (auto& t : producers) t.join();
+        for (size_t l = 0; l < n_labeler; l++) push_wait(played_queue, nullptr, nullptr);
+        for (auto& t : labelers) t.join();
+        push_wait(labelled_queue, nullptr, nullptr);
+        writer.join();
+
+        bool ok = (store.count() == _written);
+        store.close();
+        return ok;
+    }
+
+    // produce()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    void SelfPlayPipeline<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::produce(_DomainPlayer* playerW, _DomainPlayer* playerB, size_t n_game, _Queue& free_queue, _Queue& played_queue)
+    {
+        std::stringstream ss;
+        size_t num_pos_eval = 0;
+        for (size_t g = _next_game++; g < n_game; g = _next_game++)
+        {
+            GameItem* item = pop_wait(free_queue);
+            item->_game = (uint32_t)g;
+            item->_n = 0;
+            {
+                RngScope rng_scope(RngMaster::stream(RngStreamId::selfplay).stream(_spcfg._seed).stream(g));
+                _Board board = playerW->domain()->get_random_position(true);
+                item->add(board);
+                item->_score = play_game_fast(board, *playerW, *playerB, _cfg, num_pos_eval, ss, [item](const _Move&, const _Board& b) { item->add(b); });
+            }
+            _games++;
+            _positions += item->_n;
+            push_wait(played_queue, item, &_producer_waits);
+        }
+    }
+
+    // label()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    void SelfPlayPipeline<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::label(_Queue& played_queue, _Queue& labelled_queue)
+    {
+        const _Domain* domain = _playerW->domain();
+        while (true)
+        {
+            GameItem* item = pop_wait(played_queue);
+            if (item == nullptr) return;
+
+            size_t n_known = 0;
+            item->_labels.resize(item->_n);
+            for (size_t i = 0; i < item->_n; i++)
+            {
+                item->_labels[i] = tb_score(domain, item->_positions[i]);
+                if (item->_labels[i] != ExactScore::UNKNOWN) n_known++;
+            }
+            _labelled += n_known;
+            push_wait(labelled_queue, item, &_labeler_waits);
+        }
+    }
+
+    // write()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    void SelfPlayPipeline<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::write(_Queue& labelled_queue, _Queue& free_queue, _SelfPlayStore& store)
+    {
+        _Sample s;
+        while (true)
+        {
+            GameItem* item = pop_wait(labelled_queue);
+            if (item == nullptr) return;
+
+            for (size_t i = 0; i < item->_n; i++)
+            {
+                if ((item->_labels[i] == ExactScore::UNKNOWN) && !_spcfg._keep_unknown) continue;
+
+                s.from_board(item->_positions[i]);
+                s._tb_score = item->_labels[i];
+                s._game_score = item->_score;
+                s._ply = (uint16_t)i;
+                s._game = item->_game;
+                if (store.append(s)) _written++;
+            }
+            push_wait(free_queue, item, nullptr);
+        }
+    }
+};
+
+#endif
@@ -97,8 +97,10 @@ namespace chess
             return filename;
         }
 
+        // create_persist_key() - unique across threads (Ex: node changer candidates trained concurrently save their algos)
         std::string create_persist_key() const
         {
+            std::lock_guard<std::mutex> lock(_persist_key_mutex);
             _persist_key_counter++;
             std::stringstream ss;
             ss << _persist_key_counter;
@@ -157,6 +159,7 @@ namespace chess
         static std::unique_ptr<PersistManager>      _instance;
         static std::string                          _default_root_folder;
         static uint64_t                             _persist_key_counter;
+        static std::mutex                           _persist_key_mutex;     // create_persist_key() called from concurrent candidate trainings
     };
 
     template <typename PieceID, typename uint8_t _BoardSize>
@@ -170,5 +173,8 @@ namespace chess
 
     template <typename PieceID, typename uint8_t _BoardSize>
     uint64_t PersistManager<PieceID, _BoardSize>::_persist_key_counter = 0;
+
+    template <typename PieceID, typename uint8_t _BoardSize>
+    std::mutex PersistManager<PieceID, _BoardSize>::_persist_key_mutex;
 }
 #endif
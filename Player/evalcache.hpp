@@ -0,0 +1,76 @@
+#pragma once
+//=================================================================================================
+//                    Copyright (C) 2017 Alain Lanthier - All Rights Reserved                      
+//=================================================================================================
+//
+// EvalCache<TYPE_PARAM> : fixed size (power of 2) always-replace hash table of position evaluations
+//
+// One cache per thread (thread_instance()) so no locking is needed. Keys are a position hash
+// mixed with the evaluating player salt: a player changing its weights takes a new salt and all
+// its previous entries simply stop matching.
+//
+#ifndef _AL_CHESS_PLAYER_EVALCACHE_HPP
+#define _AL_CHESS_PLAYER_EVALCACHE_HPP
+
+namespace chess
+{
+    template <typename TYPE_PARAM>
+    class EvalCache
+    {
+        struct Entry
+        {
+            uint64_t    _key = 0;
+            TYPE_PARAM  _value = 0;
+            bool        _used = false;
+        };
+
+    public:
+        explicit EvalCache(uint8_t size_log2 = _default_size_log2) : _mask((((size_t)1) << size_log2) - 1)
+        {
+            _entries.resize(_mask + 1);
+        }
+
+        bool probe(uint64_t key, TYPE_PARAM& ret_value) const
+        {
+            const Entry& e = _entries[(size_t)key & _mask];
+            if (e._used && (e._key == key))
+            {
+                ret_value = e._value;
+                return true;
+            }
+            return false;
+        }
+
+        void store(uint64_t key, TYPE_PARAM value)
+        {
+            Entry& e = _entries[(size_t)key & _mask];
+            e._key = key;
+            e._value = value;
+            e._used = true;
+        }
+
+        void clear()
+        {
+            for (auto& e : _entries) e = Entry();
+        }
+
+        size_t size() const { return _entries.size(); }
+
+        static EvalCache& thread_instance()
+        {
+            static thread_local EvalCache cache;
+            return cache;
+        }
+
+        static uint8_t  _default_size_log2;     // 2^16 entries per thread
+
+    private:
+        size_t              _mask;
+        std::vector<Entry>  _entries;
+    };
+
+    template <typename TYPE_PARAM>
+    uint8_t EvalCache<TYPE_PARAM>::_default_size_log2 = 16;
+};
+
+#endif
@@ -31,6 +31,7 @@ namespace chess
         using _BasePlayer   = BasePlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
         using _Partition    = Partition<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
         using _PlayerFactory = PlayerFactory<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
+        using _CondValuNodeProgram = CondValuNodeProgram<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>;
 
         friend class _PlayerFactory;
         friend class _Partition;
@@ -45,14 +46,43 @@ namespace chess
         _ConditionValuationNode* _root;                     // The brain of the player that we evolve!
         std::vector<_DomainPlayer*> _children_players;      // can delete/attach/detach as needed
 
+        // Search state (principal variation)
+        uint16_t                        _search_depth;      // depth of the current iterative deepening iteration
+        std::vector<std::vector<_Move>> _pv_table;          // triangular PV table [ply][0..depth-ply]
+        std::vector<_Move>              _pv_line;           // PV of the last completed search
+        SearchStats                     _stats;             // counters of the last select_move_algo()
+        uint64_t                        _eval_salt;         // mixed in eval cache keys, renewed when weights change
+        _CondValuNodeProgram            _program;           // _root compiled, rebuilt lazily after invalidate_eval_cache()
+        std::atomic<bool>               _program_valid;
+        std::mutex                      _program_mutex;
+        bool                            _is_clone;          // see clone()
+
+        // Search options
+        static bool         _use_pvs;                       // null window search for non PV moves
+        static TYPE_PARAM   _aspiration_window;             // initial half window around previous iteration score (0 = full window)
+        static TYPE_PARAM   _null_window;                   // width of the null window (eval is continuous in (0..1))
+        static bool         _use_tb_probe;                  // probe loaded TB in search after capture/promotion
+        static TYPE_PARAM   _tb_dtc_unit;                   // exact TB score adjusted by dtc to prefer faster win/slower loss
+        static bool         _use_eval_cache;                // per thread eval hash cache in eval_position_algo
+        static bool         _use_compiled_nodes;            // evaluate with the compiled node program instead of walking the tree
+        static std::atomic<uint64_t> _eval_salt_counter;
+
     public:
         DomainPlayer(   PieceColor color_player, const std::string& playername, 
                         uint32_t ga_instance,   // position in a GA population
                         const std::string& partition_key, const std::string& domainname_key, const std::string& instance_key);
 
+    protected:
+        DomainPlayer(const _DomainPlayer& src, _ConditionValuationNode* root);
+
     public:
         virtual ~DomainPlayer();
 
+        // clone() - copy of the player with its own node tree, for concurrent games (Ex: GA tournament workers)
+        //           Not attached to the domains and no children players: child domains are evaluated by the attached players.
+        _DomainPlayer*      clone() const { return new DomainPlayer(*this, _root->clone_tree(nullptr)); }
+        bool                is_clone() const { return _is_clone; }
+
         virtual size_t      select_move_algo(   _Board& pos, std::vector<_Move>& m, size_t max_num_position_per_move, size_t max_num_position, uint16_t max_depth_per_move, uint16_t max_game_ply, size_t& num_pos_eval, char verbose, std::stringstream& verbose_stream)  override;
         virtual TYPE_PARAM  eval_position_algo( _Board& pos, std::vector<_Move>& m, char verbose, std::stringstream& verbose_stream)  override;
 
@@ -74,6 +104,23 @@ namespace chess
         virtual GameDB<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>* get_game_db();
 
         PieceColor              color_player() { return _color_player;}
+        const std::vector<_Move>& pv_line() const { return _pv_line; }
+        const SearchStats&      search_stats() const { return _stats; }
+
+        static bool         use_pvs()                           { return _use_pvs; }
+        static TYPE_PARAM   aspiration_window()                 { return _aspiration_window; }
+        static void         set_use_pvs(bool v)                 { _use_pvs = v; }
+        static void         set_aspiration_window(TYPE_PARAM v) { _aspiration_window = v; }
+        static bool         use_tb_probe()                      { return _use_tb_probe; }
+        static void         set_use_tb_probe(bool v)            { _use_tb_probe = v; }
+        static bool         use_eval_cache()                    { return _use_eval_cache; }
+        static void         set_use_eval_cache(bool v)          { _use_eval_cache = v; }
+        static bool         use_compiled_nodes()                { return _use_compiled_nodes; }
+        static void         set_use_compiled_nodes(bool v)      { _use_compiled_nodes = v; }
+
+        void                invalidate_eval_cache();            // must be called when weights/nodes of the player (or its children) change
+        bool                eval_root(const _Board& pos, const std::vector<_Move>& m, TYPE_PARAM& ret_eval, char verbose, std::stringstream& verbose_stream);
+        const _CondValuNodeProgram& program();
 
     protected:
         TYPE_PARAM minimax(_Board& board, uint16_t depth, TYPE_PARAM alpha, TYPE_PARAM beta,
@@ -82,8 +129,28 @@ namespace chess
                             bool is_recursive_entry, char verbose, std::stringstream& verbose_stream);
 
         bool is_same_domain(const DomainPlayer* p) const;
+        void order_pv_move(std::vector<_Move>& m, size_t ply) const;
+        void update_pv(size_t ply, const _Move& mv);
+        bool probe_tb(const _Board& board, TYPE_PARAM& ret_eval) const;
     };
 
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT> 
+    bool DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::_use_pvs = true;
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT> 
+    TYPE_PARAM DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::_aspiration_window = (TYPE_PARAM)0.05;
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT> 
+    TYPE_PARAM DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::_null_window = (TYPE_PARAM)0.000001;
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT> 
+    bool DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::_use_tb_probe = true;
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT> 
+    TYPE_PARAM DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::_tb_dtc_unit = (TYPE_PARAM)0.00001;
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT> 
+    bool DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::_use_eval_cache = true;
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT> 
+    bool DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::_use_compiled_nodes = true;
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT> 
+    std::atomic<uint64_t> DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::_eval_salt_counter(0);
+
     // DomainPlayer()
     template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
     DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>
@@ -95,7 +162,11 @@ namespace chess
                 _domainname_key(domainname_key),
                 _instance_key(instance_key),
                 _domain(nullptr),
-                _root(nullptr) // initially empty, must be fill or load
+                _root(nullptr), // initially empty, must be fill or load
+                _search_depth(0),
+                _eval_salt(hash_mix64(++_eval_salt_counter)),
+                _program_valid(false),
+                _is_clone(false)
     {
         _root = new _ConditionValuationNode(nullptr, true, false);
 
@@ -120,10 +191,30 @@ namespace chess
         }
     }
 
+    // DomainPlayer() - clone of src owning root
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>
+    ::DomainPlayer(const _DomainPlayer& src, _ConditionValuationNode* root)
+            :   _BasePlayer(src._playername, src._ga_instance),
+                _color_player(src._color_player),
+                _partition_key(src._partition_key),
+                _domainname_key(src._domainname_key),
+                _instance_key(src._instance_key),
+                _domain(src._domain),
+                _root(root),
+                _search_depth(0),
+                _eval_salt(hash_mix64(++_eval_salt_counter)),
+                _program_valid(false),
+                _is_clone(true)
+    {
+        _ga_fitness = src._ga_fitness;
+        _elo = src._elo;
+    }
+
     template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
     DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::~DomainPlayer()
     {
-        detachFromDomains();
+        if (!_is_clone) detachFromDomains();   // a clone would detach the original (same domain keys)
         _children_players.clear();
         delete _root;
     }
@@ -213,6 +304,7 @@ namespace chess
                 _children_players[i]->load();
                 // recursion
             }
+            invalidate_eval_cache();
 
             is.close();
             return true;
@@ -221,7 +313,7 @@ namespace chess
         return false;
     }
 
-    // minimax
+    // minimax (alpha/beta with principal variation search)
     template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
     TYPE_PARAM DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::
     minimax(_Board& board, uint16_t depth, TYPE_PARAM a, TYPE_PARAM b, bool isMaximizing, 
@@ -231,6 +323,9 @@ namespace chess
     {
         size_t best_a_idx = 0;
         size_t best_b_idx = 0;
+        size_t ply = (depth <= _search_depth) ? (size_t)(_search_depth - depth) : 0;
+        if (ply < _pv_table.size()) _pv_table[ply].clear();
+        _stats._nodes++;
 
         std::vector<_Move> m = board.generate_moves();
         if (board.is_final(m))
@@ -241,13 +336,28 @@ namespace chess
             if (sc == ExactScore::LOSS) return (TYPE_PARAM)+0.0;
             return (TYPE_PARAM)+0.5;
         }
-        else if (   (depth == 0) || 
+        else if (   _use_tb_probe && is_recursive_entry &&
+                    (board.is_last_move_capture() || board.is_last_move_promo()))
+        {
+            // material signature changed - exact score if a TB is loaded for it
+            TYPE_PARAM tb_eval;
+            _stats._tb_probes++;
+            if (probe_tb(board, tb_eval))
+            {
+                _stats._tb_hits++;
+                return tb_eval;
+            }
+        }
+
+        if (        (depth == 0) || 
                     (cnt_num_position_per_move >= max_num_position_per_move) || 
                     (cnt_num_pos_eval >= max_num_node) || 
                     (board.get_histo_size() >= max_game_ply))
         {
             cnt_num_pos_eval++;
             cnt_num_position_per_move++;
+            _stats._qnodes++;
+            _stats._eval_calls++;
             if (verbose > 2)
             {
                 _Move m = board.last_history_move();
@@ -257,17 +367,42 @@ namespace chess
             return eval_position_algo(board, m, verbose, verbose_stream);
         }
 
+        // PV move of the previous iteration is searched first
+        order_pv_move(m, ply);
+
+        TYPE_PARAM temp;
+        _stats._interior_nodes++;
         if (isMaximizing)
         {
             for (size_t i = 0; i < m.size(); i++)
             {
+                _stats._children_searched++;
                 board.apply_move(m[i]);
-                TYPE_PARAM temp = this->minimax(board, depth - 1, a, b, false, max_num_position_per_move, max_num_node, max_game_ply, ret_mv_idx, cnt_num_position_per_move, cnt_num_pos_eval, true, verbose, verbose_stream);
-                if (temp >= a) best_a_idx = i;
-                a = std::max<TYPE_PARAM>(a, temp);
+                if ((i == 0) || (!_use_pvs))
+                {
+                    temp = this->minimax(board, depth - 1, a, b, false, max_num_position_per_move, max_num_node, max_game_ply, ret_mv_idx, cnt_num_position_per_move, cnt_num_pos_eval, true, verbose, verbose_stream);
+                }
+                else
+                {
+                    // null window: prove the move is not better than a
+                    temp = this->minimax(board, depth - 1, a, a + _null_window, false, max_num_position_per_move, max_num_node, max_game_ply, ret_mv_idx, cnt_num_position_per_move, cnt_num_pos_eval, true, verbose, verbose_stream);
+                    if ((temp > a) && (temp < b))
+                    {
+                        _stats._pvs_researches++;
+                        temp = this->minimax(board, depth - 1, a, b, false, max_num_position_per_move, max_num_node, max_game_ply, ret_mv_idx, cnt_num_position_per_move, cnt_num_pos_eval, true, verbose, verbose_stream);
+                    }
+                }
                 board.undo_move();
+                if ((i == 0) || (temp > a))
+                {
+                    best_a_idx = i;
+                    update_pv(ply, m[i]);
+                }
+                a = std::max<TYPE_PARAM>(a, temp);
                 if (b <= a)
                 {
+                    _stats._cutoffs++;
+                    if (i == 0) _stats._cutoffs_first_move++;
                     return b; // b cutoff.
                 }
             }
@@ -278,13 +413,33 @@ namespace chess
         {
             for (size_t i = 0; i < m.size(); i++)
             {
+                _stats._children_searched++;
                 board.apply_move(m[i]);
-                TYPE_PARAM temp = this->minimax(board, depth - 1, a, b, true, max_num_position_per_move, max_num_node, max_game_ply, ret_mv_idx, cnt_num_position_per_move, cnt_num_pos_eval, true, verbose, verbose_stream);
-                if (temp <= b) best_b_idx = i;
-                b = std::min(b, temp);
+                if ((i == 0) || (!_use_pvs))
+                {
+                    temp = this->minimax(board, depth - 1, a, b, true, max_num_position_per_move, max_num_node, max_game_ply, ret_mv_idx, cnt_num_position_per_move, cnt_num_pos_eval, true, verbose, verbose_stream);
+                }
+                else
+                {
+                    // null window: prove the move is not better than b
+                    temp = this->minimax(board, depth - 1, b - _null_window, b, true, max_num_position_per_move, max_num_node, max_game_ply, ret_mv_idx, cnt_num_position_per_move, cnt_num_pos_eval, true, verbose, verbose_stream);
+                    if ((temp < b) && (temp > a))
+                    {
+                        _stats._pvs_researches++;
+                        temp = this->minimax(board, depth - 1, a, b, true, max_num_position_per_move, max_num_node, max_game_ply, ret_mv_idx, cnt_num_position_per_move, cnt_num_pos_eval, true, verbose, verbose_stream);
+                    }
+                }
                 board.undo_move();
+                if ((i == 0) || (temp < b))
+                {
+                    best_b_idx = i;
+                    update_pv(ply, m[i]);
+                }
+                b = std::min(b, temp);
                 if (b <= a)
                 {
+                    _stats._cutoffs++;
+                    if (i == 0) _stats._cutoffs_first_move++;
                     return a; // a cutoff.
                 }
             }
@@ -293,6 +448,48 @@ namespace chess
         }
     }
 
+    // order_pv_move() - move the PV move at this ply (if any) in front
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    void DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::order_pv_move(std::vector<_Move>& m, size_t ply) const
+    {
+        if (ply >= _pv_line.size()) return;
+        for (size_t i = 1; i < m.size(); i++)
+        {
+            if (m[i].is_same(_pv_line[ply]))
+            {
+                std::rotate(m.begin(), m.begin() + i, m.begin() + i + 1);
+                return;
+            }
+        }
+    }
+
+    // update_pv() - PV at ply is mv followed by the PV of ply+1
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    void DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::update_pv(size_t ply, const _Move& mv)
+    {
+        if (ply >= _pv_table.size()) return;
+        _pv_table[ply].clear();
+        _pv_table[ply].push_back(mv);
+        if (ply + 1 < _pv_table.size())
+            _pv_table[ply].insert(_pv_table[ply].end(), _pv_table[ply + 1].begin(), _pv_table[ply + 1].end());
+    }
+
+    // probe_tb() - exact TB score mapped in eval space (WIN near 1, LOSS near 0), adjusted by dtc
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    bool DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::probe_tb(const _Board& board, TYPE_PARAM& ret_eval) const
+    {
+        ExactScore  sc;
+        uint8_t     dtc = 0;
+        if (!TB_Manager<PieceID, _BoardSize>::instance()->probe(board, sc, dtc))
+            return false;
+
+        if      (sc == ExactScore::WIN)  ret_eval = (TYPE_PARAM)1.0 - _tb_dtc_unit * (TYPE_PARAM)dtc;
+        else if (sc == ExactScore::LOSS) ret_eval = (TYPE_PARAM)0.0 + _tb_dtc_unit * (TYPE_PARAM)dtc;
+        else if (sc == ExactScore::DRAW) ret_eval = (TYPE_PARAM)0.5;
+        else return false;
+        return true;
+    }
+
     // select_move_algo
     template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
     size_t DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::
@@ -301,6 +498,9 @@ namespace chess
                         uint16_t    max_depth_per_move,             uint16_t max_game_ply, 
                         size_t&     cnt_num_pos_eval,               char verbose, std::stringstream& verbose_stream)
     {
+        // a known score move is a search of no node: no stats or PV of a previous search left (the caller reads or sums them)
+        _stats.clear();
+        _pv_line.clear();
         if (_domain != nullptr)
         {
             if (_domain->has_known_score_move())
@@ -313,15 +513,97 @@ namespace chess
             }
         }
         
-        // classic alpha/beta minmax
-        TYPE_PARAM  a = -std::numeric_limits<TYPE_PARAM>::max();    // eval is only in (0..1) currently
-        TYPE_PARAM  b = std::numeric_limits<TYPE_PARAM>::max();
+        // iterative deepening alpha/beta minmax (PVS) with aspiration window around previous iteration score
+        const TYPE_PARAM lowest  = -std::numeric_limits<TYPE_PARAM>::max();    // eval is only in (0..1) currently
+        const TYPE_PARAM highest = std::numeric_limits<TYPE_PARAM>::max();
         size_t      ret_best_move_index = 0;
         size_t      cnt_num_position_per_move = 0;
-        TYPE_PARAM  e = minimax(pos, max_depth_per_move, a, b, pos.get_color() == PieceColor::W,    
-                                max_num_position_per_move, max_num_position, max_game_ply, 
-                                ret_best_move_index, cnt_num_position_per_move, cnt_num_pos_eval, false, verbose, verbose_stream);
-        return ret_best_move_index;
+        TYPE_PARAM  e = 0.5;
+        TYPE_PARAM  delta;
+        TYPE_PARAM  a;
+        TYPE_PARAM  b;
+        TYPE_PARAM  v;
+        bool        budget_done = false;
+        uint64_t    depth_nodes;
+        std::chrono::time_point<std::chrono::high_resolution_clock> depth_start;
+
+        for (uint16_t d = 1; d <= max_depth_per_move; d++)
+        {
+            depth_start = std::chrono::high_resolution_clock::now();
+            depth_nodes = _stats._nodes;
+            _search_depth = d;
+            _pv_table.assign(d + 1, std::vector<_Move>());
+
+            delta = _aspiration_window;
+            if ((d == 1) || (delta <= 0)) { a = lowest; b = highest; }
+            else { a = e - delta; b = e + delta; }
+
+            while (true)
+            {
+                v = minimax(pos, d, a, b, pos.get_color() == PieceColor::W,
+                            max_num_position_per_move, max_num_position, max_game_ply, 
+                            ret_best_move_index, cnt_num_position_per_move, cnt_num_pos_eval, false, verbose, verbose_stream);
+
+                budget_done = (cnt_num_position_per_move >= max_num_position_per_move) || (cnt_num_pos_eval >= max_num_position);
+                if (budget_done) break;
+
+                // widen gradually on fail low/high
+                if ((v <= a) && (a > lowest))
+                {
+                    _stats._aspiration_researches++;
+                    delta *= 2;
+                    a = (delta >= 1) ? lowest : e - delta;
+                }
+                else if ((v >= b) && (b < highest))
+                {
+                    _stats._aspiration_researches++;
+                    delta *= 2;
+                    b = (delta >= 1) ? highest : e + delta;
+                }
+                else break;
+            }
+            // an iteration cut by the budget is partial: keep the eval and PV of the last completed one (if any)
+            if (!budget_done || _pv_line.empty())
+            {
+                e = v;
+                if (_pv_table[0].size() > 0) _pv_line = _pv_table[0];
+                _stats._depth_reached = d;
+            }
+            _stats._depth_nodes.push_back(_stats._nodes - depth_nodes);
+            _stats._depth_time_ms.push_back(std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - depth_start).count());
+
+            if (verbose > 1)
+            {
+                verbose_stream << "depth " << d << " eval " << e << " pv";
+                for (auto& mv : _pv_line) verbose_stream << " " << mv.to_str();
+                verbose_stream << std::endl;
+            }
+            if (budget_done) break;
+        }
+
+        // best move: first move of the PV, else ret_best_move_index in the root move list (generation order, no PV to reorder it)
+        std::vector<_Move> root_m;
+        const _Move* best = nullptr;
+        if (_pv_line.size() > 0)
+        {
+            best = &_pv_line[0];
+        }
+        else
+        {
+            root_m = pos.generate_moves();
+            if (ret_best_move_index < root_m.size()) best = &root_m[ret_best_move_index];
+        }
+
+        // map the best move to the caller move list
+        if (best != nullptr)
+        {
+            for (size_t i = 0; i < m.size(); i++)
+            {
+                if (m[i].is_same(*best))
+                    return i;
+            }
+        }
+        return 0;
     }
 
     // eval_position_algo
@@ -330,21 +612,46 @@ namespace chess
     eval_position_algo(_Board& pos, std::vector<_Move>& m, char verbose, std::stringstream& verbose_stream)
     {
         TYPE_PARAM ret_eval = 0.5;
-        bool ret = _root->eval_position(pos, m, ret_eval, verbose, verbose_stream);
-        if (ret == true) return ret_eval;
+        uint64_t key = 0;
+        if (_use_eval_cache)
+        {
+            key = pos.get_hash_key() ^ _eval_salt;
+            _stats._eval_cache_probes++;
+            if (EvalCache<TYPE_PARAM>::thread_instance().probe(key, ret_eval))
+            {
+                _stats._eval_cache_hits++;
+                return ret_eval;
+            }
+        }
+
+        bool ret = eval_root(pos, m, ret_eval, verbose, verbose_stream);
+        if (ret == true)
+        {
+            if (_use_eval_cache) EvalCache<TYPE_PARAM>::thread_instance().store(key, ret_eval);
+            return ret_eval;
+        }
 
         // This is first layer of children domain (should make sure it cover all sub domains)
+        // a child eval is cached under the child salt: the child weights can change without the parent being invalidated
         for (size_t i = 0; i < _domain->_children.size(); i++)
         {
-            if (_color_player == PieceColor::W)
+            DomainPlayer* child = (_color_player == PieceColor::W) ? _domain->_children[i]->_attached_domain_playerW : _domain->_children[i]->_attached_domain_playerB;
+            uint64_t child_key = 0;
+            if (_use_eval_cache)
             {
-                ret = _domain->_children[i]->_attached_domain_playerW->_root->eval_position(pos, m, ret_eval, verbose, verbose_stream);
+                child_key = pos.get_hash_key() ^ child->_eval_salt;
+                _stats._eval_cache_probes++;
+                if (EvalCache<TYPE_PARAM>::thread_instance().probe(child_key, ret_eval))
+                {
+                    _stats._eval_cache_hits++;
+                    return ret_eval;
+                }
             }
-            else
+            if (child->eval_root(pos, m, ret_eval, verbose, verbose_stream))
             {
-                ret = _domain->_children[i]->_attached_domain_playerB->_root->eval_position(pos, m, ret_eval, verbose, verbose_stream);
+                if (_use_eval_cache) EvalCache<TYPE_PARAM>::thread_instance().store(child_key, ret_eval);
+                return ret_eval;
             }
-            if (ret == true) return ret_eval;
         }
 
         // Failure if hole in the hiearchy of the domains of the partition throw...
@@ -352,6 +659,45 @@ namespace chess
         return ret_eval;
     }
 
+    // invalidate_eval_cache() - new salt so previous cached evals of this player no longer match
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    void DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::invalidate_eval_cache()
+    {
+        _eval_salt = hash_mix64(++_eval_salt_counter);
+        _program_valid = false;
+        for (auto& v : _children_players) v->invalidate_eval_cache();
+    }
+
+    // program() - compiled _root, recompiled at first use after an invalidate_eval_cache()
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    const CondValuNodeProgram<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>& DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::program()
+    {
+        if (!_program_valid)
+        {
+            std::lock_guard<std::mutex> lock(_program_mutex);
+            if (!_program_valid)
+            {
+                _program.compile(_root);
+                _program_valid = true;
+            }
+        }
+        return _program;
+    }
+
+    // eval_root() - eval of the player own tree (compiled program, or tree walk when verbose detail is requested)
+    template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
+    bool DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>::
+    eval_root(const _Board& pos, const std::vector<_Move>& m, TYPE_PARAM& ret_eval, char verbose, std::stringstream& verbose_stream)
+    {
+        if (_use_compiled_nodes && (verbose <= 2))
+        {
+            const _CondValuNodeProgram& prog = program();
+            if (prog.is_compiled())
+                return prog.eval(pos, m, ret_eval);
+        }
+        return _root->eval_position(pos, m, ret_eval, verbose, verbose_stream);
+    }
+
     // detachFromDomains()
     template <typename PieceID, typename uint8_t _BoardSize, typename TYPE_PARAM, int PARAM_NBIT>
     bool DomainPlayer<PieceID, _BoardSize, TYPE_PARAM, PARAM_NBIT>:: detachFromDomains()
@@ -372,6 +718,7 @@ namespace chess
             }
         }
 
+        if (this->_domain == nullptr) return true;     // player of an unknown domain (never attached)
         if (this->_color_player == PieceColor::W)
         {
             if (this->_domain->_attached_domain_playerW != nullptr)
@@ -0,0 +1,112 @@
+#pragma once
+//=================================================================================================
+//                    Copyright (C) 2017 Alain Lanthier - All Rights Reserved                      
+//=================================================================================================
+//
+// SearchStats : per search counters of a player (nodes, cutoffs, eval cache/TB hits, time per depth)
+//
+// Counters are cheap increments done inside the search, a player keeps the stats of its last
+// select_move_algo() and BaseGame accumulates them per move/game for CSV or JSON export.
+//
+#ifndef _AL_CHESS_PLAYER_SEARCHSTATS_HPP
+#define _AL_CHESS_PLAYER_SEARCHSTATS_HPP
+
+namespace chess
+{
+    struct SearchStats
+    {
+        uint64_t    _nodes = 0;                 // minimax entries
+        uint64_t    _qnodes = 0;                // leaf nodes (horizon/budget) - no quiescence search yet, leaf are evaluated statically
+        uint64_t    _eval_calls = 0;            // eval_position_algo calls
+        uint64_t    _interior_nodes = 0;        // nodes whose children were searched
+        uint64_t    _children_searched = 0;     // sum of children searched at interior nodes
+        uint64_t    _cutoffs = 0;               // alpha/beta cutoffs
+        uint64_t    _cutoffs_first_move = 0;    // cutoffs at the first move searched
+        uint64_t    _pvs_researches = 0;        // null window fail followed by full window re-search
+        uint64_t    _aspiration_researches = 0; // root fail low/high re-search
+        uint64_t    _eval_cache_probes = 0;     // leaf eval cache probes (EvalCache)
+        uint64_t    _eval_cache_hits = 0;
+        uint64_t    _tb_probes = 0;             // tablebase probes in search
+        uint64_t    _tb_hits = 0;
+        uint16_t    _depth_reached = 0;
+        std::vector<double>     _depth_time_ms; // elapsed time per iterative deepening depth
+        std::vector<uint64_t>   _depth_nodes;   // nodes per iterative deepening depth
+
+        void clear() { *this = SearchStats(); }
+
+        void add(const SearchStats& s)
+        {
+            _nodes                  += s._nodes;
+            _qnodes                 += s._qnodes;
+            _eval_calls             += s._eval_calls;
+            _interior_nodes         += s._interior_nodes;
+            _children_searched      += s._children_searched;
+            _cutoffs                += s._cutoffs;
+            _cutoffs_first_move     += s._cutoffs_first_move;
+            _pvs_researches         += s._pvs_researches;
+            _aspiration_researches  += s._aspiration_researches;
+            _eval_cache_probes      += s._eval_cache_probes;
+            _eval_cache_hits        += s._eval_cache_hits;
+            _tb_probes              += s._tb_probes;
+            _tb_hits                += s._tb_hits;
+            _depth_reached          = std::max<uint16_t>(_depth_reached, s._depth_reached);
+            if (_depth_time_ms.size() < s._depth_time_ms.size()) _depth_time_ms.resize(s._depth_time_ms.size(), 0.0);
+            if (_depth_nodes.size() < s._depth_nodes.size())     _depth_nodes.resize(s._depth_nodes.size(), 0);
+            for (size_t i = 0; i < s._depth_time_ms.size(); i++) _depth_time_ms[i] += s._depth_time_ms[i];
+            for (size_t i = 0; i < s._depth_nodes.size(); i++)   _depth_nodes[i] += s._depth_nodes[i];
+        }
+
+        double first_move_cutoff_ratio() const  { return (_cutoffs > 0)        ? (double)_cutoffs_first_move / (double)_cutoffs : 0.0; }
+        double eval_cache_hit_rate() const      { return (_eval_cache_probes > 0) ? (double)_eval_cache_hits / (double)_eval_cache_probes : 0.0; }
+        double tb_hit_rate() const              { return (_tb_probes > 0)      ? (double)_tb_hits / (double)_tb_probes : 0.0; }
+        double branching_factor() const         { return (_interior_nodes > 0) ? (double)_children_searched / (double)_interior_nodes : 0.0; }
+        double total_time_ms() const
+        {
+            double t = 0;
+            for (auto& v : _depth_time_ms) t += v;
+            return t;
+        }
+
+        static std::string csv_header()
+        {
+            return "nodes,qnodes,eval_calls,branching_factor,cutoffs,first_move_cutoff_ratio,pvs_researches,aspiration_researches,"
+                   "eval_cache_probes,eval_cache_hit_rate,tb_probes,tb_hit_rate,depth_reached,time_ms,depth_time_ms";
+        }
+
+        std::string to_csv() const
+        {
+            std::stringstream ss;
+            ss << _nodes << "," << _qnodes << "," << _eval_calls << "," << branching_factor() << ",";
+            ss << _cutoffs << "," << first_move_cutoff_ratio() << "," << _pvs_researches << "," << _aspiration_researches << ",";
+            ss << _eval_cache_probes << "," << eval_cache_hit_rate() << "," << _tb_probes << "," << tb_hit_rate() << ",";
+            ss << _depth_reached << "," << total_time_ms() << ",";
+            for (size_t i = 0; i < _depth_time_ms.size(); i++)
+            {
+                if (i > 0) ss << ";";
+                ss << _depth_time_ms[i];
+            }
+            return ss.str();
+        }
+
+        std::string to_json() const
+        {
+            std::stringstream ss;
+            ss << "{";
+            ss << "\"nodes\":" << _nodes << ",\"qnodes\":" << _qnodes << ",\"eval_calls\":" << _eval_calls;
+            ss << ",\"branching_factor\":" << branching_factor();
+            ss << ",\"cutoffs\":" << _cutoffs << ",\"first_move_cutoff_ratio\":" << first_move_cutoff_ratio();
+            ss << ",\"pvs_researches\":" << _pvs_researches << ",\"aspiration_researches\":" << _aspiration_researches;
+            ss << ",\"eval_cache_probes\":" << _eval_cache_probes << ",\"eval_cache_hit_rate\":" << eval_cache_hit_rate();
+            ss << ",\"tb_probes\":" << _tb_probes << ",\"tb_hit_rate\":" << tb_hit_rate();
+            ss << ",\"depth_reached\":" << _depth_reached << ",\"time_ms\":" << total_time_ms();
+            ss << ",\"depth_time_ms\":[";
+            for (size_t i = 0; i < _depth_time_ms.size(); i++) { if (i > 0) ss << ","; ss << _depth_time_ms[i]; }
+            ss << "],\"depth_nodes\":[";
+            for (size_t i = 0; i < _depth_nodes.size(); i++)   { if (i > 0) ss << ","; ss << _depth_nodes[i]; }
+            ss << "]}";
+            return ss.str();
+        }
+    };
+};
+
+#endif
@@ -43,6 +43,8 @@ namespace chess
         TablebaseBase<PieceID, _BoardSize>*  find_sym(const std::string& name) const;
         TablebaseBase<PieceID, _BoardSize>*  find_N(uint8_t N, const std::string& name) const { return find_N(name); }
 
+        bool probe(const Board<PieceID, _BoardSize>& pos, ExactScore& ret_sc, uint8_t& ret_dtc) const;
+
         std::vector<STRUCT_TBH<PieceID, _BoardSize>> make_all_child_TBH(const PieceSet<PieceID, _BoardSize>& set, TBH_IO_MODE iomode, TBH_OPTION option) const;
 
     public:
@@ -159,6 +161,41 @@ namespace chess
         return nullptr;
     }
 
+    // probe() - score/dtc of a position whose material signature match a built and loaded TB (no disk load here)
+    template <typename PieceID, typename uint8_t _BoardSize>
+    inline bool TB_Manager<PieceID, _BoardSize>::probe(const Board<PieceID, _BoardSize>& pos, ExactScore& ret_sc, uint8_t& ret_dtc) const
+    {
+        if (_instance == nullptr) return false;
+        if (pos.get_color() == PieceColor::none) return false;
+
+        std::vector<PieceID> v_id = pos.get_piecesID();        // sorted
+        PieceSet<PieceID, _BoardSize> ps(PieceSet<PieceID, _BoardSize>::to_set(v_id, PieceColor::W), PieceSet<PieceID, _BoardSize>::to_set(v_id, PieceColor::B));
+        uint16_t nw = ps.count_all_piece(PieceColor::W);
+        uint16_t nb = ps.count_all_piece(PieceColor::B);
+        if ((nw == 0) || (nb == 0)) return false;
+
+        std::string tb_name = name_pieces(v_id, pos.get_color());
+        TablebaseBase<PieceID, _BoardSize>* tb = (nw < nb) ? find_sym(tb_name) : find_N(tb_name);
+        if (tb == nullptr) return false;
+        if (!tb->is_build_and_loaded()) return false;
+
+        std::map<size_t, STRUCT_PIECE_RANK<PieceID, _BoardSize>>& map_piece_rank = ps.map_piece_rank();
+        std::vector<uint16_t> v_sq; v_sq.assign(v_id.size(), 0);
+        for (size_t z = 0; z < v_id.size(); z++)
+        {
+            v_sq[z] = pos.get_square_ofpiece_instance(
+                        Piece<PieceID, _BoardSize>::get(map_piece_rank[z].ret_id)->get_name(),
+                        Piece<PieceID, _BoardSize>::get(map_piece_rank[z].ret_id)->get_color(),
+                        map_piece_rank[z].ret_instance);
+        }
+        tb->order_sq_v(v_sq, v_id);
+
+        ret_sc = tb->score_v(v_sq);
+        if (ret_sc == ExactScore::UNKNOWN) return false;    // partial TB
+        ret_dtc = tb->dtc_v(v_sq);
+        return true;
+    }
+
     // instance()
     template <typename PieceID, typename uint8_t _BoardSize>
     const TB_Manager<PieceID, _BoardSize>* 
@@ -48,6 +48,557 @@ TEST_CASE("TestClass", "[func]") {
     REQUIRE(a.func() == true);
 }
 
+TEST_CASE("BatchEvaluator matches the scalar weight_sum sigmoid", "[batch_eval]") {
+
+    std::mt19937_64 gen(12345);
+    std::uniform_real_distribution<double> x_dist(-400.0, 400.0);
+    std::uniform_real_distribution<double> w_dist(-10.0, 10.0);
+
+    for (size_t nrow : { 1, 7, 8, 13, 100 })
+    {
+        const size_t ncol = 9;
+        FeatureMatrix X(nrow, ncol);
+        std::vector<double> w(ncol);
+        for (auto& v : w) v = w_dist(gen);
+        for (size_t j = 0; j < nrow; j++)
+            for (size_t f = 0; f < ncol; f++) X.at(j, f) = x_dist(gen);
+
+        std::vector<double> ref;
+        BatchEvaluator::force_level(SimdLevel::scalar);
+        BatchEvaluator::weight_sum_sigmoid(X, w, SIGMOID_SCALE, ref);
+        REQUIRE(ref.size() == nrow);
+        for (size_t j = 0; j < nrow; j++)
+        {
+            double c = 0;
+            for (size_t f = 0; f < ncol; f++) c = c + w[f] * X.at(j, f);
+            REQUIRE(ref[j] == Approx(sigmoid(c)).epsilon(1e-12));
+        }
+
+        // every instruction set gives the scalar result bit for bit
+        for (SimdLevel l : { SimdLevel::sse2, SimdLevel::avx2, SimdLevel::avx512 })
+        {
+            std::vector<double> out;
+            BatchEvaluator::force_level(l);
+            BatchEvaluator::weight_sum_sigmoid(X, w, SIGMOID_SCALE, out);
+            REQUIRE(out == ref);
+        }
+        BatchEvaluator::reset_level();
+    }
+}
+
+// Stub candidate algos of the node changer: no dataset, a fixed test error, training threads recorded
+class TestNodeChangerLog
+{
+public:
+    void add() { std::lock_guard<std::mutex> lock(_mutex); _threads.push_back(std::this_thread::get_id()); }
+    std::vector<std::thread::id> threads() { std::lock_guard<std::mutex> lock(_mutex); return _threads; }
+private:
+    std::mutex                      _mutex;
+    std::vector<std::thread::id>    _threads;
+};
+
+class TestCondAlgo : public FeatureCondAlgo<uint8_t, 6, double, 16>
+{
+public:
+    TestCondAlgo(const FeatureAlgoConfig<uint8_t, 6, double, 16>& cfg) : FeatureCondAlgo<uint8_t, 6, double, 16>(cfg) {}
+
+    FeatureAlgo<uint8_t, 6, double, 16>* clone() const override { return new TestCondAlgo(*this); }
+    bool prepare(DomainPlayer<uint8_t, 6, double, 16>&, ConditionValuationNode<uint8_t, 6, double, 16>*, size_t) override { return true; }
+    bool train(DomainPlayer<uint8_t, 6, double, 16>&, ConditionValuationNode<uint8_t, 6, double, 16>*, size_t, char) override { return true; }
+    bool test(DomainPlayer<uint8_t, 6, double, 16>&, ConditionValuationNode<uint8_t, 6, double, 16>*, size_t) override { return true; }
+    bool compare(DomainPlayer<uint8_t, 6, double, 16>&, ConditionValuationNode<uint8_t, 6, double, 16>*, size_t) override { return true; }
+    void cleanup(DomainPlayer<uint8_t, 6, double, 16>&, ConditionValuationNode<uint8_t, 6, double, 16>*, size_t) override {}
+    bool get_condition_value(bool, bool, const Board<uint8_t, 6>&, const std::vector<Move<uint8_t>>&) const override { return true; }
+};
+
+class TestValuAlgo : public FeatureValuAlgo<uint8_t, 6, double, 16>
+{
+public:
+    TestValuAlgo(const FeatureAlgoConfig<uint8_t, 6, double, 16>& cfg, double error, TestNodeChangerLog* log)
+        : FeatureValuAlgo<uint8_t, 6, double, 16>(cfg), _error(error), _log(log) {}
+
+    FeatureAlgo<uint8_t, 6, double, 16>* clone() const override { return new TestValuAlgo(*this); }
+    bool prepare(DomainPlayer<uint8_t, 6, double, 16>&, ConditionValuationNode<uint8_t, 6, double, 16>*, size_t) override { return true; }
+    bool train(DomainPlayer<uint8_t, 6, double, 16>&, ConditionValuationNode<uint8_t, 6, double, 16>*, size_t, char) override
+    {
+        if (_log != nullptr) _log->add();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));     // both candidates in flight together when parallel
+        return true;
+    }
+    bool test(DomainPlayer<uint8_t, 6, double, 16>&, ConditionValuationNode<uint8_t, 6, double, 16>*, size_t) override
+    {
+        cfg()._test_dataset_average_error = _error;
+        return true;
+    }
+    bool compare(DomainPlayer<uint8_t, 6, double, 16>&, ConditionValuationNode<uint8_t, 6, double, 16>*, size_t) override { return true; }
+    void cleanup(DomainPlayer<uint8_t, 6, double, 16>&, ConditionValuationNode<uint8_t, 6, double, 16>*, size_t) override {}
+    double get_valuations_value(const Board<uint8_t, 6>&, const std::vector<Move<uint8_t>>&, char, std::stringstream&) const override { return 0.5; }
+
+private:
+    double              _error;
+    TestNodeChangerLog* _log;
+};
+
+class TestNodeChanger : public CondValuNodeChanger<uint8_t, 6, double, 16>
+{
+public:
+    TestNodeChanger(double child_error) : _child_error(child_error) {}
+    TestNodeChangerLog _log;
+
+protected:
+    double _child_error;
+
+    FeatureAlgo<uint8_t, 6, double, 16>* suggest_algo_for_change(DomainPlayer<uint8_t, 6, double, 16>&, ConditionValuationNode<uint8_t, 6, double, 16>*, bool changing_cond) override
+    {
+        FeatureAlgoConfig<uint8_t, 6, double, 16> cfg;
+        cfg._is_cond = changing_cond;
+        cfg._name = changing_cond ? FeatureBasedAlgoName::cond_product_boolean : FeatureBasedAlgoName::valu_weight_sum;
+        if (changing_cond) return new TestCondAlgo(cfg);
+        return new TestValuAlgo(cfg, _child_error, &_log);
+    }
+};
+
+TEST_CASE("CondValuNodeChanger expands a terminal node serially and in parallel", "[node_changer]") {
+
+    using _DomainPlayer = DomainPlayer<uint8_t, 6, double, 16>;
+
+    for (bool parallel : { false, true })
+    {
+        CondValuNodeChanger<uint8_t, 6, double, 16>::set_parallel_eval(parallel);
+
+        // root without valuation: any split is better
+        {
+            _DomainPlayer player(PieceColor::W, "testnodechanger", 0, "testnodechanger", "none", "0");
+            TestNodeChanger changer(0.2);
+            bool changed = false;
+            REQUIRE(changer.try_expand_terminal_node_cond(player, 100, changed));
+            REQUIRE(changed);
+
+            ConditionValuationNode<uint8_t, 6, double, 16>* pos = player.get_root()->positive_child();
+            ConditionValuationNode<uint8_t, 6, double, 16>* neg = player.get_root()->negative_child();
+            REQUIRE(pos != nullptr);
+            REQUIRE(neg != nullptr);
+            REQUIRE(pos->current_cond_algo() != nullptr);
+            REQUIRE(pos->current_valu_algo() != nullptr);
+            REQUIRE(neg->current_valu_algo() != nullptr);
+            REQUIRE(neg->current_valu_algo()->cfg()._test_dataset_average_error == 0.2);    // trained on the player clone when parallel
+
+            // Fvalu(0) and Fvalu(1): one on the caller thread, the other concurrently when parallel
+            std::vector<std::thread::id> threads = changer._log.threads();
+            REQUIRE(threads.size() == 2);
+            REQUIRE((std::count(threads.begin(), threads.end(), std::this_thread::get_id()) == 1) == parallel);
+        }
+
+        // root valuation better than the children: split undone
+        {
+            _DomainPlayer player(PieceColor::W, "testnodechanger", 0, "testnodechanger", "none", "0");
+            FeatureAlgoConfig<uint8_t, 6, double, 16> cfg;
+            cfg._is_cond = false;
+            cfg._name = FeatureBasedAlgoName::valu_weight_sum;
+            TestValuAlgo* root_algo = new TestValuAlgo(cfg, 0.1, nullptr);
+            root_algo->cfg()._test_dataset_average_error = 0.1;
+            player.get_root()->set_test_valu_algo(root_algo);
+            player.get_root()->update_valu_algo();
+
+            TestNodeChanger changer(0.2);
+            bool changed = false;
+            REQUIRE(changer.try_expand_terminal_node_cond(player, 100, changed));
+            REQUIRE(!changed);
+            REQUIRE(player.get_root()->positive_child() == nullptr);
+            REQUIRE(player.get_root()->negative_child() == nullptr);
+            REQUIRE(changer._log.threads().size() == 2);
+        }
+    }
+    CondValuNodeChanger<uint8_t, 6, double, 16>::set_parallel_eval(true);
+}
+
+TEST_CASE("FeatureMatrixCache save/load round trip", "[feature_cache]") {
+
+    using _FeatureMatrixCache = FeatureMatrixCache<uint8_t, 6, double, 16>;
+
+    std::mt19937_64 gen(777);
+    std::uniform_real_distribution<double> x_dist(-100.0, 100.0);
+
+    FeatureDataset ds;
+    ds.clear(5);
+    for (size_t j = 0; j < 20; j++)
+    {
+        for (size_t f = 0; f < ds._nfeature; f++) ds._x.push_back(x_dist(gen));
+        ds._y.push_back((double)((int)(j % 3) - 1));
+    }
+
+    std::string key = "domain=test/roundtrip;color=1;valu=a(1)b(2);path=+null|";
+    REQUIRE(_FeatureMatrixCache::save(key, 20, ds));
+
+    FeatureDataset r;
+    REQUIRE(_FeatureMatrixCache::load(key, 20, r));
+    REQUIRE(r._nfeature == ds._nfeature);
+    REQUIRE(r.size() == ds.size());
+    for (size_t i = 0; i < ds._x.size(); i++) REQUIRE(r._x[i] == (double)(float)ds._x[i]);     // stored as float
+    REQUIRE(r._y == ds._y);
+
+    // first rows serve smaller requests, not larger ones (domain not exhausted)
+    REQUIRE(_FeatureMatrixCache::load(key, 7, r));
+    REQUIRE(r.size() == 7);
+    REQUIRE(r._x.size() == 7 * ds._nfeature);
+    REQUIRE(!_FeatureMatrixCache::load(key, 21, r));
+
+    // saved again over the existing file, other key not found
+    REQUIRE(_FeatureMatrixCache::save(key, 20, ds));
+    REQUIRE(_FeatureMatrixCache::load(key, 20, r));
+    REQUIRE(r.size() == ds.size());
+    REQUIRE(!_FeatureMatrixCache::load(key + "x", 20, r));
+
+    std::remove(_FeatureMatrixCache::file_name(key).c_str());
+}
+
+TEST_CASE("TexelTuner recovers known weights on a synthetic dataset", "[texel]") {
+
+    // labels drawn from the weight_sum model itself: WIN with probability sigmoid(a * w.x), else LOSS
+    const std::vector<double> w_true = { 2.0, -1.5, 0.5, 0.0 };
+    std::mt19937_64 gen(2024);
+    std::uniform_real_distribution<double> x_dist(-1000.0, 1000.0);
+    std::uniform_real_distribution<double> u_dist(0.0, 1.0);
+
+    FeatureDataset ds;
+    ds.clear(w_true.size());
+    for (size_t j = 0; j < 20000; j++)
+    {
+        double s = 0;
+        for (size_t f = 0; f < w_true.size(); f++) { double x = x_dist(gen); ds._x.push_back(x); s += w_true[f] * x; }
+        ds._y.push_back((u_dist(gen) < 1.0 / (1.0 + std::exp(-SIGMOID_SCALE * s))) ? +1.0 : -1.0);
+    }
+
+    for (TexelOptimizer opt : { TexelOptimizer::lbfgs, TexelOptimizer::adam })
+    {
+        TexelTuner::set_optimizer(opt);
+        TexelTuner::set_learning_rate(0.05);
+
+        std::vector<double> w(w_true.size(), 0.0);
+        TexelTunerResult r;
+        REQUIRE(TexelTuner::tune(ds, w, 0.0, 0, &r));
+        REQUIRE(r._loss_end < r._loss_start);
+        for (size_t f = 0; f < w.size(); f++) REQUIRE(std::abs(w[f] - w_true[f]) < 0.15);
+
+        // bounded: weights stay in the box
+        std::vector<double> wb(w_true.size(), 0.0);
+        REQUIRE(TexelTuner::tune(ds, wb, 1.0, 0));
+        for (size_t f = 0; f < wb.size(); f++) REQUIRE(std::abs(wb[f]) <= 1.0);
+        REQUIRE(wb[0] == Approx(1.0));
+        REQUIRE(wb[1] == Approx(-1.0));
+    }
+    TexelTuner::set_optimizer(TexelOptimizer::adam);
+    TexelTuner::set_learning_rate(1.0);
+}
+
+TEST_CASE("GeneticAlgorithm resumed from a checkpoint matches the uninterrupted run", "[ga_checkpoint]") {
+
+    using _GA = galgo::GeneticAlgorithm<double, 16>;
+    struct F { static std::vector<double> objective(const std::vector<double>& x)
+    { return { -(x[0] - 0.3) * (x[0] - 0.3) - (x[1] + 0.2) * (x[1] + 0.2) - x[2] * x[2] }; } };
+
+    std::vector<double> lo = { -1, -1, -1 };
+    std::vector<double> up = { 1, 1, 1 };
+    std::vector<double> init = { 0, 0, 0 };
+    std::string file = "ga_checkpoint_test.ckpt";
+    std::remove(file.c_str());
+
+    // uninterrupted 10 generations
+    RngMaster::set_seed(42);
+    _GA ga_full(20, 10, lo, up, init);
+    ga_full.Objective = F::objective;
+    ga_full.genstep = 100;
+    ga_full.run();
+
+    // stopped after 8 generations (checkpoints at 4 and 8)
+    RngMaster::set_seed(42);
+    _GA ga_stop(20, 8, lo, up, init);
+    ga_stop.Objective = F::objective;
+    ga_stop.genstep = 100;
+    ga_stop.checkpoint_file = file;
+    ga_stop.checkpoint_step = 4;
+    ga_stop.run();
+
+    // resumed to 10 generations under another seed: the checkpoint restores it
+    RngMaster::set_seed(7);
+    _GA ga_resume(20, 10, lo, up, init);
+    ga_resume.Objective = F::objective;
+    ga_resume.genstep = 100;
+    ga_resume.checkpoint_file = file;
+    REQUIRE(ga_resume.resume());
+    REQUIRE(ga_resume.best_history().size() == 11);
+    REQUIRE(ga_resume.best_history() == ga_full.best_history());
+    REQUIRE(ga_resume.result()->getParam() == ga_full.result()->getParam());
+
+    // a checkpoint of another GA is refused and leaves the GA untouched
+    _GA ga_other(30, 10, lo, up, init);
+    ga_other.checkpoint_file = file;
+    REQUIRE(!ga_other.load_checkpoint());
+    REQUIRE(ga_other.best_history().empty());
+
+    std::remove(file.c_str());
+}
+
+// Classic6Players - W and B players of the classic6 KQvK domain, all valuation features on the root (in memory)
+struct Classic6Players
+{
+    using _DomainPlayer = DomainPlayer<uint8_t, 6, double, 16>;
+    using _ConditionValuationNode = ConditionValuationNode<uint8_t, 6, double, 16>;
+
+    std::unique_ptr<_DomainPlayer>      _playW;
+    std::unique_ptr<_DomainPlayer>      _playB;
+    std::vector<std::vector<double>>    _weights[2];    // initial terminal node weights of W and B
+
+    Classic6Players(const std::string& name)
+    {
+        PartitionManager<uint8_t, 6, double, 16>::instance()->make_classic_partition();
+        std::string domain = Domain<uint8_t, 6, double, 16>::getDomainName(eDomainName::KQvK);
+        _playW.reset(new _DomainPlayer(PieceColor::W, "w" + name, 0, "classic6", domain, "0"));
+        _playB.reset(new _DomainPlayer(PieceColor::B, "b" + name, 0, "classic6", domain, "0"));
+
+        PlayerFactoryConfig cfg = { CondFeatureSelection::none, ValuFeatureSelection::all, true };
+        PlayerFactory<uint8_t, 6, double, 16>::instance()->reconfigPlayerRootNode(_playW.get(), cfg);
+        PlayerFactory<uint8_t, 6, double, 16>::instance()->reconfigPlayerRootNode(_playB.get(), cfg);
+        _weights[0] = weights(_playW.get());
+        _weights[1] = weights(_playB.get());
+    }
+
+    static std::vector<std::vector<double>> weights(_DomainPlayer* player)
+    {
+        std::vector<_ConditionValuationNode*> nodes;
+        player->get_root()->get_term_nodes(nodes);
+        std::vector<std::vector<double>> w;
+        for (auto& node : nodes) w.push_back(node->get_weights());
+        return w;
+    }
+
+    // reset() - initial weights back in both players
+    void reset()
+    {
+        for (int k = 0; k < 2; k++)
+        {
+            _DomainPlayer* player = (k == 0) ? _playW.get() : _playB.get();
+            std::vector<_ConditionValuationNode*> nodes;
+            player->get_root()->get_term_nodes(nodes);
+            for (size_t i = 0; i < nodes.size(); i++) nodes[i]->set_weights(_weights[k][i]);
+            player->invalidate_eval_cache();
+        }
+    }
+};
+
+TEST_CASE("ChessCoEvolveGA resumed from its checkpoints matches the uninterrupted run", "[ga_checkpoint]") {
+
+    using _ChessCoEvolveGA = ga::ChessCoEvolveGA<uint8_t, 6, double, 16, 10>;
+
+    Classic6Players players("coevolve_resume");
+    REQUIRE(players._playW->domain() != nullptr);
+    REQUIRE(!players._weights[0].empty());
+
+    BaseGame_Config cfg{ 100, 1, 100, 1, 2000, 10 };
+    std::string files[2] = {
+        PersistManager<uint8_t, 6>::instance()->get_stream_name("gacheckpoint", players._playW->persist_key()),
+        PersistManager<uint8_t, 6>::instance()->get_stream_name("gacheckpoint", players._playB->persist_key()) };
+    for (auto& f : files) std::remove(f.c_str());
+
+    // uninterrupted 3 generations
+    players.reset();
+    RngMaster::set_seed(42);
+    {
+        _ChessCoEvolveGA ga_full(players._playW.get(), players._playB.get(), cfg, 1, 4, 3, 2, 2, 0);
+        ga_full.run();
+    }
+    std::vector<std::vector<double>> full_W = Classic6Players::weights(players._playW.get());
+    std::vector<std::vector<double>> full_B = Classic6Players::weights(players._playB.get());
+    double full_fitness_W = players._playW->ga_fitness();
+    double full_fitness_B = players._playB->ga_fitness();
+
+    // stopped after 2 generations (both GA checkpointed each generation)
+    players.reset();
+    RngMaster::set_seed(42);
+    {
+        _ChessCoEvolveGA ga_stop(players._playW.get(), players._playB.get(), cfg, 1, 4, 2, 2, 2, 0);
+        ga_stop.set_checkpoint(1);
+        ga_stop.run();
+    }
+
+    // resumed to 3 generations under another seed: the checkpoints restore it
+    players.reset();
+    RngMaster::set_seed(7);
+    {
+        _ChessCoEvolveGA ga_resume(players._playW.get(), players._playB.get(), cfg, 1, 4, 3, 2, 2, 0);
+        ga_resume.set_checkpoint(1);
+        REQUIRE(ga_resume.resume());
+    }
+    REQUIRE(Classic6Players::weights(players._playW.get()) == full_W);
+    REQUIRE(Classic6Players::weights(players._playB.get()) == full_B);
+    REQUIRE(players._playW->ga_fitness() == full_fitness_W);
+    REQUIRE(players._playB->ga_fitness() == full_fitness_B);
+
+    // one side checkpoint missing: refused, players untouched
+    players.reset();
+    std::remove(files[1].c_str());
+    {
+        _ChessCoEvolveGA ga_other(players._playW.get(), players._playB.get(), cfg, 1, 4, 3, 2, 2, 0);
+        ga_other.set_checkpoint(1);
+        REQUIRE(!ga_other.resume());
+    }
+    REQUIRE(Classic6Players::weights(players._playW.get()) == players._weights[0]);
+    REQUIRE(Classic6Players::weights(players._playB.get()) == players._weights[1]);
+
+    for (auto& f : files) std::remove(f.c_str());
+}
+
+// TestChessGA - final population fitness of a ChessGeneticAlgorithm run
+class TestChessGA : public ga::ChessGeneticAlgorithm<uint8_t, 6, double, 16, 10>
+{
+public:
+    TestChessGA(DomainPlayer<uint8_t, 6, double, 16>* playW, DomainPlayer<uint8_t, 6, double, 16>* playB, BaseGame_Config cfg)
+        : ga::ChessGeneticAlgorithm<uint8_t, 6, double, 16, 10>(true, false, playW, playB, cfg, 6, 2, 2, 2, 0)
+    {
+    }
+
+    std::vector<double> fitness() const
+    {
+        std::vector<double> v;
+        for (int i = 0; i < popsize; i++) v.push_back(pop(i)->getTotal());
+        return v;
+    }
+
+    // start() - created population evaluated, reevaluate() - evaluated again (same generation, same openings), stop() - run finished
+    void start() { prepare_run(); init_population(false); }
+    void stop() { finish_run(); }
+    void reevaluate()
+    {
+        std::vector<galgo::CHR<double, 16>> chrs;
+        for (int i = 0; i < popsize; i++) chrs.push_back(pop.get_cur(i));
+        evaluate_batch(chrs, 0, popsize, false);
+    }
+};
+
+TEST_CASE("ChessGeneticAlgorithm parallel tournament fitness equals the sequential run", "[ga_parallel]") {
+
+    using _ChessGeneticAlgorithm = ga::ChessGeneticAlgorithm<uint8_t, 6, double, 16, 10>;
+
+    Classic6Players players("parallel_tournament");
+    REQUIRE(players._playW->domain() != nullptr);
+    BaseGame_Config cfg{ 100, 1, 100, 1, 2000, 10 };
+
+    for (bool game_batch : { false, true })
+    {
+        _ChessGeneticAlgorithm::set_game_batch(game_batch);
+
+        // 1 thread: the GA own game and players
+        players.reset();
+        RngMaster::set_seed(42);
+        _ChessGeneticAlgorithm::set_parallel_tournament(false);
+        std::vector<double> fitness_1;
+        std::vector<double> history_1;
+        {
+            TestChessGA ga_1(players._playW.get(), players._playB.get(), cfg);
+            ga_1.run(false);
+            fitness_1 = ga_1.fitness();
+            history_1 = ga_1.best_history();
+        }
+        std::vector<std::vector<double>> weights_1 = Classic6Players::weights(players._playW.get());
+
+        // 4 workers: per worker game and player clones
+        players.reset();
+        RngMaster::set_seed(42);
+        _ChessGeneticAlgorithm::set_parallel_tournament(true);
+        TaskPool pool(4);
+        std::vector<double> fitness_n;
+        std::vector<double> history_n;
+        {
+            TestChessGA ga_n(players._playW.get(), players._playB.get(), cfg);
+            ga_n.set_task_pool(&pool);
+            ga_n.run(false);
+            fitness_n = ga_n.fitness();
+            history_n = ga_n.best_history();
+        }
+
+        REQUIRE(fitness_1.size() == 6);
+        REQUIRE(fitness_n == fitness_1);
+        REQUIRE(history_n == history_1);
+        REQUIRE(Classic6Players::weights(players._playW.get()) == weights_1);
+    }
+    _ChessGeneticAlgorithm::set_game_batch(true);
+    players.reset();
+}
+
+TEST_CASE("ChessGeneticAlgorithm fitness cache reuses a pair, then averages new games up to the re-evaluation count", "[ga_fitness_cache]") {
+
+    using _ChessGeneticAlgorithm = ga::ChessGeneticAlgorithm<uint8_t, 6, double, 16, 10>;
+
+    Classic6Players players("fitness_cache");
+    REQUIRE(players._playW->domain() != nullptr);
+    BaseGame_Config cfg{ 100, 1, 100, 1, 2000, 10 };
+    size_t reevaluate = _ChessGeneticAlgorithm::fitness_reevaluate();
+    const size_t n_game = 6 * 2 * 2;        // popsize * tournament players * games, all against the opposite player
+
+    players.reset();
+    RngMaster::set_seed(42);
+    _ChessGeneticAlgorithm::set_fitness_reevaluate(4);
+    {
+        TestChessGA ga(players._playW.get(), players._playB.get(), cfg);
+        ga.start();
+        REQUIRE(ga.fitness_cache_hits() == 0);
+        REQUIRE(ga.fitness_cache_games() == n_game);
+        std::vector<double> fitness = ga.fitness();
+
+        // each pair has its 4 games: reused, nothing played
+        ga.reevaluate();
+        REQUIRE(ga.fitness_cache_hits() == n_game);
+        REQUIRE(ga.fitness_cache_games() == n_game);
+        REQUIRE(ga.fitness() == fitness);
+
+        // up to 8 games: every pair plays again and its new games are averaged in, then it is reused
+        _ChessGeneticAlgorithm::set_fitness_reevaluate(8);
+        ga.reevaluate();
+        REQUIRE(ga.fitness_cache_hits() == n_game);
+        REQUIRE(ga.fitness_cache_games() == 2 * n_game);
+        ga.reevaluate();
+        REQUIRE(ga.fitness_cache_hits() == 2 * n_game);
+        REQUIRE(ga.fitness_cache_games() == 2 * n_game);
+
+        // another master seed draws another opening set: the memoized pairs do not apply
+        RngMaster::set_seed(43);
+        ga.reevaluate();
+        REQUIRE(ga.fitness_cache_hits() == 2 * n_game);
+        REQUIRE(ga.fitness_cache_games() == 3 * n_game);
+        ga.stop();
+    }
+    _ChessGeneticAlgorithm::set_fitness_reevaluate(reevaluate);
+    players.reset();
+}
+
+TEST_CASE("MatchStats SPRT waits for min_sample and floors the variance", "[sprt]") {
+
+    SprtConfig cfg{ -40.0, 40.0, 0.1, 0.1, 8, 0.05 };
+    MatchStats stats;
+
+    // straight wins: no spread, no decision before min_sample, then H1
+    for (size_t i = 0; i < 7; i++)
+    {
+        stats.add_game(1.0);
+        REQUIRE(stats.sprt(cfg) == SprtResult::none);
+    }
+    REQUIRE(stats.variance() == 0.0);
+    REQUIRE(std::isfinite(stats.llr(cfg)));
+    stats.add_game(1.0);
+    REQUIRE(stats.sprt(cfg) == SprtResult::H1);
+
+    // straight losses: H0
+    stats.clear();
+    for (size_t i = 0; i < 8; i++) stats.add_game(0.0);
+    REQUIRE(stats.sprt(cfg) == SprtResult::H0);
+
+    // even score: undecided
+    stats.clear();
+    for (size_t i = 0; i < 50; i++) { stats.add_game(1.0); stats.add_game(0.0); stats.add_game(0.5); }
+    REQUIRE(stats.sprt(cfg) == SprtResult::none);
+    REQUIRE(std::abs(stats.llr(cfg)) < MatchStats::upper_bound(cfg));
+}
+
 int main(int argc, char* argv[])
 {
     {
@@ -15,6 +15,13 @@ int main(int argc, char* argv[])
 {
     srand((unsigned int)time(NULL));
 
+    // Island model: --islands N launches N local processes of this executable (--island i each)
+    galgo::IslandConfig island = galgo::IslandConfig::from_args(argc, argv);
+    if ((island.nbisland > 1) && (island.island < 0))
+        return galgo::run_islands(argv[0], island);
+    if (island.enabled())
+        chess::RngMaster::set_seed(island.island_seed());
+
     // Test GA
     // Prepare players for GA
     {
@@ -102,6 +109,7 @@ int main(int argc, char* argv[])
                     chess::BaseGame_Config cfg{ 1000, 1, 1000, 1, 20000, 10 };
                     //Param: num_iter, popsize, nbgen, _tournament_n_player, _tournament_n_game, verbose
                     chess::ga::ChessCoEvolveGA<uint8_t, 6, double, 16, 10> ga_co(playW, playB, cfg, 1, 5, 1, 2, 1, 1);
+                    ga_co.set_island(island);
                     ga_co.run();
 
                     delete playW;
@@ -118,6 +126,7 @@ int main(int argc, char* argv[])
                     // Evolve
                     chess::BaseGame_Config cfg{ 1000, 1, 1000, 1, 20000, 30 };
                     chess::ga::ChessCoEvolveGA<uint8_t, 6, double, 16, 10> ga_co(playW, playB, cfg, 1, 5, 3, 10, 1, 2);
+                    ga_co.set_island(island);
                     ga_co.run();
 
                     delete playW;
@@ -0,0 +1,85 @@
+//=================================================================================================
+//                    Copyright (C) 2017 Alain Lanthier - All Rights Reserved                      
+//=================================================================================================
+//
+// Executable
+// Regression test: match of candidate players against baseline players (paired games, SPRT)
+//
+//
+#include "core/chess.hpp"
+
+//-----------------------------------------------------------------------
+// testmatch.exe -cw wplayer -cb bplayer -bw wplayer -bb bplayer [options]
+// -cw -cb : candidate players (saved players of the domain)
+// -bw -bb : baseline players
+// -partition name (classic6) -domain name (KQvK) -instance id (0)
+// -elo0 x (0) -elo1 x (5) -alpha x (0.05) -beta x (0.05) : SPRT, -minpairs n (16) : pairs before a decision
+// -pairs n (1000) : maximum pairs of games, -positions n (200) : opening positions, -seed n (0) : positions seed
+// -threads n (all) -v (optional): verbose
+//
+// Return: 0 candidate stronger (H1), 1 candidate not stronger (H0), 2 undecided, 3 error
+//-----------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    using _DomainPlayer = chess::DomainPlayer<uint8_t, 6, double, 16>;
+    using _Domain = chess::Domain<uint8_t, 6, double, 16>;
+
+    unittest::cmd_parser cmd(argc, argv);
+    auto opt = [&cmd](const std::string& name, const std::string& def) -> std::string
+    {
+        return cmd.get_option(name).empty() ? def : cmd.get_option(name);
+    };
+
+    if (opt("-cw", "").empty() || opt("-cb", "").empty() || opt("-bw", "").empty() || opt("-bb", "").empty())
+    {
+        std::cout << "Usage: testmatch -cw wplayer -cb bplayer -bw wplayer -bb bplayer [options]" << std::endl;
+        return 3;
+    }
+
+    const std::string partition = opt("-partition", "classic6");
+    const std::string domain = opt("-domain", "KQvK");
+    const std::string instance = opt("-instance", "0");
+
+    chess::Partition<uint8_t, 6, double, 16>* p = chess::PartitionManager<uint8_t, 6, double, 16>::instance()->load_partition(partition);
+    if ((p == nullptr) || (p->find_domain(domain, instance) == nullptr))
+    {
+        std::cout << "Domain not found: " << partition << " " << domain << " " << instance << std::endl;
+        return 3;
+    }
+
+    _DomainPlayer candW(chess::PieceColor::W, opt("-cw", ""), 0, partition, domain, instance);
+    _DomainPlayer candB(chess::PieceColor::B, opt("-cb", ""), 0, partition, domain, instance);
+    _DomainPlayer baseW(chess::PieceColor::W, opt("-bw", ""), 0, partition, domain, instance);
+    _DomainPlayer baseB(chess::PieceColor::B, opt("-bb", ""), 0, partition, domain, instance);
+    if (!candW.load() || !candB.load() || !baseW.load() || !baseB.load())
+    {
+        std::cout << "Players not found" << std::endl;
+        return 3;
+    }
+    candW.attachToDomains();    // child domains positions are played by the candidate children players
+    candB.attachToDomains();
+
+    chess::SprtConfig sprt;
+    sprt._elo0 = std::stod(opt("-elo0", "0"));
+    sprt._elo1 = std::stod(opt("-elo1", "5"));
+    sprt._alpha = std::stod(opt("-alpha", "0.05"));
+    sprt._beta = std::stod(opt("-beta", "0.05"));
+    sprt._min_sample = (size_t)std::stoul(opt("-minpairs", "16"));
+
+    size_t nthread = (size_t)std::stoul(opt("-threads", std::to_string(std::thread::hardware_concurrency())));
+    chess::TaskPool pool(nthread);
+
+    chess::BaseGame_Config cfg{ 1000, 1, 1000, 1, 20000, 30 };
+    chess::MatchManager<uint8_t, 6, double, 16> match(&candW, &candB, &baseW, &baseB, cfg, &pool);
+    match.set_random_positions((size_t)std::stoul(opt("-positions", "200")), std::stoull(opt("-seed", "0")));
+
+    chess::SprtResult r = match.run(sprt, (size_t)std::stoul(opt("-pairs", "1000")), 64, cmd.has_option("-v") ? 1 : 0);
+
+    std::cout << "Candidate " << opt("-cw", "") << "/" << opt("-cb", "") << " vs baseline " << opt("-bw", "") << "/" << opt("-bb", "") << std::endl;
+    std::cout << match.stats().to_string() << std::endl;
+    std::cout << "SPRT [" << sprt._elo0 << ", " << sprt._elo1 << "] : " << chess::SprtResult_to_string(r) << std::endl;
+
+    if (r == chess::SprtResult::H1) return 0;
+    if (r == chess::SprtResult::H0) return 1;
+    return 2;
+}
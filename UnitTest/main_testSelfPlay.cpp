@@ -0,0 +1,124 @@
+//=================================================================================================
+//                    Copyright (C) 2017 Alain Lanthier - All Rights Reserved                      
+//=================================================================================================
+//
+// Executable
+// Self-play pipeline: games played, TB labelled and stored, store read back (round trip check),
+// then the store feeds the texel datasets of the W player weight_sum terminal nodes
+//
+#include "core/chess.hpp"
+
+//-----------------------------------------------------------------------
+// testselfplay.exe -w wplayer -b bplayer [options]
+// -w -b : players (saved players of the domain)
+// -partition name (classic6) -domain name (KQvK) -instance id (0)
+// -games n (100) : games played, -store file (selfplay.alsp) : store (replaced), -seed n (0) : games seed
+// -producers n (0: all threads left) -labelers n (1) -queue n (64) : pipeline
+// -samples n (10000) : texel samples per node, -v (optional): verbose
+//
+// Return: 0 store read back as written and labels match the TB, 1 mismatch, 2 no texel dataset, 3 error
+//-----------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    using _DomainPlayer = chess::DomainPlayer<uint8_t, 6, double, 16>;
+    using _SelfPlayPipeline = chess::SelfPlayPipeline<uint8_t, 6, double, 16>;
+    using _SelfPlayStore = chess::SelfPlayStore<uint8_t, 6>;
+    using _ConditionValuationNode = chess::ConditionValuationNode<uint8_t, 6, double, 16>;
+    using _FeatureValuAlgo_weight_sum = chess::FeatureValuAlgo_weight_sum<uint8_t, 6, double, 16>;
+
+    unittest::cmd_parser cmd(argc, argv);
+    auto opt = [&cmd](const std::string& name, const std::string& def) -> std::string
+    {
+        return cmd.get_option(name).empty() ? def : cmd.get_option(name);
+    };
+
+    if (opt("-w", "").empty() || opt("-b", "").empty())
+    {
+        std::cout << "Usage: testselfplay -w wplayer -b bplayer [options]" << std::endl;
+        return 3;
+    }
+
+    const std::string partition = opt("-partition", "classic6");
+    const std::string domain = opt("-domain", "KQvK");
+    const std::string instance = opt("-instance", "0");
+    const std::string store_file = opt("-store", "selfplay.alsp");
+    char verbose = cmd.has_option("-v") ? 1 : 0;
+
+    chess::Partition<uint8_t, 6, double, 16>* p = chess::PartitionManager<uint8_t, 6, double, 16>::instance()->load_partition(partition);
+    if ((p == nullptr) || (p->find_domain(domain, instance) == nullptr))
+    {
+        std::cout << "Domain not found: " << partition << " " << domain << " " << instance << std::endl;
+        return 3;
+    }
+
+    _DomainPlayer playW(chess::PieceColor::W, opt("-w", ""), 0, partition, domain, instance);
+    _DomainPlayer playB(chess::PieceColor::B, opt("-b", ""), 0, partition, domain, instance);
+    if (!playW.load() || !playB.load())
+    {
+        std::cout << "Players not found" << std::endl;
+        return 3;
+    }
+    playW.attachToDomains();    // child domains positions are played by the children players
+    playB.attachToDomains();
+
+    // play, label and store
+    chess::SelfPlayConfig spcfg;
+    spcfg._n_producer = (size_t)std::stoul(opt("-producers", "0"));
+    spcfg._n_labeler = (size_t)std::stoul(opt("-labelers", "1"));
+    spcfg._queue_capacity = (size_t)std::stoul(opt("-queue", "64"));
+    spcfg._seed = std::stoull(opt("-seed", "0"));
+
+    size_t n_game = (size_t)std::stoul(opt("-games", "100"));
+    std::remove(store_file.c_str());
+
+    chess::BaseGame_Config cfg{ 1000, 1, 1000, 1, 20000, 30 };
+    _SelfPlayPipeline pipeline(&playW, &playB, cfg, spcfg);
+    if (!pipeline.run(n_game, store_file))
+    {
+        std::cout << "Self-play failed: " << store_file << std::endl;
+        return 3;
+    }
+    chess::SelfPlayStats stats = pipeline.stats();
+    std::cout << "Self-play games: " << stats._games << " positions: " << stats._positions << " labelled: " << stats._labelled;
+    std::cout << " written: " << stats._written << " waits: " << stats._producer_waits << "/" << stats._labeler_waits << std::endl;
+
+    // round trip: every sample written is read back with the TB score of its position
+    std::vector<chess::SelfPlaySample<uint8_t, 6>> samples;
+    if (!_SelfPlayStore::read(store_file, samples))
+    {
+        std::cout << "Store not readable: " << store_file << std::endl;
+        return 3;
+    }
+
+    size_t n_mismatch = 0;
+    chess::Board<uint8_t, 6> board;
+    for (auto& s : samples)
+    {
+        s.to_board(board);
+        if ((s._game >= n_game) || (_SelfPlayPipeline::tb_score(playW.domain(), board) != s._tb_score)) n_mismatch++;
+    }
+    std::cout << "Store samples: " << samples.size() << " label mismatches: " << n_mismatch << std::endl;
+    if ((samples.size() != stats._written) || (n_mismatch > 0)) return 1;
+
+    // texel datasets from the store
+    chess::FeatureDatasetBuilder<uint8_t, 6, double, 16>::set_store_file(store_file);
+    size_t max_samples = (size_t)std::stoul(opt("-samples", "10000"));
+    size_t n_tuned = 0;
+
+    std::vector<_ConditionValuationNode*> nodes;
+    playW.get_root()->get_term_nodes(nodes);
+    for (auto& node : nodes)
+    {
+        auto algo = node->current_valu_algo();
+        if ((algo == nullptr) || (algo->cfg()._name != chess::FeatureBasedAlgoName::valu_weight_sum)) continue;
+
+        chess::TexelTunerResult r;
+        if (!chess::FeatureTexelTuner<uint8_t, 6, double, 16>::tune(playW, node, *(_FeatureValuAlgo_weight_sum*)algo, max_samples, verbose, chess::TexelTuner::weight_bound(), &r))
+            continue;
+        n_tuned++;
+        std::cout << "Texel node: samples " << r._nsample << " loss " << r._loss_start << " -> " << r._loss_end << std::endl;
+    }
+    chess::FeatureDatasetBuilder<uint8_t, 6, double, 16>::set_store_file("");
+
+    return (n_tuned > 0) ? 0 : 2;
+}
@@ -140,6 +140,29 @@ namespace chess
                 return (board.cnt_piece(PieceName::P, PieceColor::W) == 8);
             }
 
+            bool check_005(uint32_t) // test FeatureContext against Board feature primitives
+            {
+                _Board::reset_to_default_option();
+                _Board board(true);
+                std::vector<_Move> m = board.generate_moves();
+                board.apply_move(m[0]);
+                m = board.generate_moves();
+
+                FeatureContext<PieceID, _BoardSize> ctx(board, m);
+                for (PieceName n : { PieceName::K, PieceName::Q, PieceName::N, PieceName::P })
+                {
+                    for (PieceColor c : { PieceColor::W, PieceColor::B })
+                    {
+                        uint16_t cnt = (c == board.get_color()) ? board.cnt_move(n, c, m) : board.cnt_move_oppo(n, c, m);
+                        if (ctx.cnt_move(_Piece::get_id(n, c)) != cnt) return false;
+                        if (ctx.squares(_Piece::get_id(n, c)).size() != board.cnt_piece(n, c)) return false;
+                    }
+                }
+                if (ctx.king_capture(board.get_color()) != board.count_capture_king()) return false;
+                if (ctx.king_capture(board.get_opposite_color()) != board.count_capture_opposite_king(m)) return false;
+                return true;
+            }
+
             bool do_test(const unittest::cmd_parser& cmd)
             {
                 unittest::TTest<TestBoard<PieceID, _BoardSize>> tester = unittest::TTest<TestBoard<PieceID, _BoardSize>>();
@@ -152,6 +175,7 @@ namespace chess
                 tester.add_test(this, &TestBoard::check_003a, id++, "err003a", "undo_move (allow_self_check = true)");
                 tester.add_test(this, &TestBoard::check_003b, id++, "err003b", "undo_move (allow_self_check = false)");
                 tester.add_test(this, &TestBoard::check_004,  id++, "err004",  "cnt_piece()");
+                tester.add_test(this, &TestBoard::check_005,  id++, "err005",  "FeatureContext");
 
                 bool ret = tester.run();
                 if (cmd.has_option("-r"))